@@ -0,0 +1,89 @@
+/*
+ * cached_evaluation.cpp
+ * Benchmark for lam.symbols
+ * A ten binder potential evaluated by compile() and by cache() when one
+ * binder changes per call: x (few subtrees read it), eps (almost all of
+ * them do), or none.
+ *
+ * usage: bench_cached_evaluation [calls]
+ *
+ * Author: Colin Ford
+ * License: CC0-1.0 Universal
+ */
+
+import std;
+import lam.symbols;
+
+using namespace lam::symbols;
+
+constexpr symbol x;
+constexpr symbol gm;
+constexpr symbol m1;
+constexpr symbol m2;
+constexpr symbol m3;
+constexpr symbol m4;
+constexpr symbol a;
+constexpr symbol b;
+constexpr symbol c;
+constexpr symbol eps;
+
+// Softened pair terms; only the last one depends on x
+constexpr auto potential = gm * (m1 + m2) / ((a * a + eps * eps) ^ 1.5) +
+                           gm * (m3 * m4) / ((b * b + c * c + eps * eps) ^ 0.75) +
+                           gm * m1 * x / ((x * x + eps * eps) ^ 1.5);
+
+// Out of line, so the compiler cannot hoist the unchanged binders out of the loop
+template<typename Kernel>
+[[gnu::noinline]] double call(Kernel& kernel, const std::array<double, 10>& inputs)
+{ return std::apply(kernel, inputs); }
+
+// Best of five runs of calls with binder Changing set to the k-th value (Changing = 10: no binder changes)
+template<std::size_t Changing, typename Kernel>
+double ns_per_call(Kernel& kernel, std::span<const double> values, std::size_t calls)
+{
+  double best = std::numeric_limits<double>::max();
+  for (int run = 0; run < 5; ++run)
+  {
+    std::array<double, 10> inputs{0.5, 1.0, 2.0, 3.0, 0.25, 0.75, 1.5, 2.5, 3.5, 0.1};
+    double sum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t k = 0; k < calls; ++k)
+    {
+      if constexpr (Changing < 10)
+        inputs[Changing] = values[k % values.size()];
+      sum += call(kernel, inputs);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    if (sum == 42.0) // keep the calls alive
+      std::println("");
+    best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(calls));
+  }
+  return best;
+}
+
+template<std::size_t Changing>
+void run(const char* name, std::span<const double> values, std::size_t calls)
+{
+  auto compiled = compile(potential, x, gm, m1, m2, m3, m4, a, b, c, eps);
+  auto cached = cache(potential, x, gm, m1, m2, m3, m4, a, b, c, eps);
+  const double full = ns_per_call<Changing>(compiled, values, calls);
+  const double incremental = ns_per_call<Changing>(cached, values, calls);
+  std::println("{:>10} {:>12.2f} {:>12.2f} {:>10.2f}x", name, full, incremental, full / incremental);
+}
+
+int main(int argc, char** argv)
+{
+  const std::size_t calls = argc > 1 ? std::stoull(argv[1]) : 10'000'000;
+  std::vector<double> values(1024);
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<double> dist(0.5, 2.0);
+  for (auto& v : values)
+    v = dist(rng);
+
+  std::println("{:>10} {:>12} {:>12} {:>11}", "changing", "compile", "cache", "speedup");
+  std::println("{:>10} {:>12} {:>12}", "", "(ns/call)", "(ns/call)");
+  run<0>("x", values, calls);
+  run<9>("eps", values, calls);
+  run<10>("none", values, calls);
+  return 0;
+}
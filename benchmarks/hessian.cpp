@@ -0,0 +1,119 @@
+/*
+ * hessian.cpp
+ * Benchmark for lam.symbols
+ * Hessian of the chained Rosenbrock objective over 10 symbols, sum of
+ * 100 (x[i+1] - x[i]^2)^2 + (1 - x[i])^2: the upper triangle in packed
+ * storage (hessian), against the 100 entries built and compiled one by one
+ * with derivative(derivative(f, x[i]), x[j]) (naive).
+ *
+ * Compile time: the same file builds bench_hessian_build_packed and
+ * bench_hessian_build_naive, each instantiating one method only; compare
+ *   time cmake --build . --target bench_hessian_build_packed
+ *   time cmake --build . --target bench_hessian_build_naive
+ *
+ * usage: bench_hessian [calls]
+ *
+ * Author: Colin Ford
+ * License: CC0-1.0 Universal
+ */
+
+import std;
+import lam.symbols;
+
+using namespace lam::symbols;
+
+#if !defined(LAM_BENCH_NAIVE_ONLY)
+#define LAM_BENCH_PACKED 1
+#endif
+#if !defined(LAM_BENCH_PACKED_ONLY)
+#define LAM_BENCH_NAIVE 1
+#endif
+
+constexpr std::size_t n = 10;
+
+template<std::size_t K>
+struct variable_tag
+{};
+template<std::size_t K>
+using variable = symbol<unconstrained, symbol_id<variable_tag<K>>{}>;
+
+constexpr auto loss = []<std::size_t... Is>(std::index_sequence<Is...>) {
+  return (... + (constant_symbol<100>{} * ((variable<Is + 1>{} - (variable<Is>{} ^ constant_symbol<2>{})) ^
+                                            constant_symbol<2>{}) +
+                 ((constant_symbol<1>{} - variable<Is>{}) ^ constant_symbol<2>{})));
+}(std::make_index_sequence<n - 1>{});
+
+template<typename Kernel>
+[[gnu::noinline]] void call_packed(const Kernel& kernel, std::span<double> out, const std::array<double, n>& inputs)
+{ std::apply([&](auto... values) { kernel.packed(out, values...); }, inputs); }
+
+// Every entry of the matrix compiled on its own, row major
+template<typename... Kernels>
+[[gnu::noinline]] void call_naive(const std::tuple<Kernels...>& kernels, std::span<double> out,
+                                  const std::array<double, n>& inputs)
+{
+  [&]<std::size_t... Ks>(std::index_sequence<Ks...>) {
+    ((out[Ks] = std::get<Ks>(kernels)(inputs)), ...);
+  }(std::index_sequence_for<Kernels...>{});
+}
+
+// Best of five runs; one input changes per call so nothing is hoisted
+template<typename Call>
+double ns_per_call(const Call& once, std::span<double> out, std::size_t calls)
+{
+  double best = std::numeric_limits<double>::max();
+  for (int run = 0; run < 5; ++run)
+  {
+    std::array<double, n> inputs{};
+    for (std::size_t i = 0; i < n; ++i)
+      inputs[i] = 0.5 + 0.01 * static_cast<double>(i);
+    double sum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t k = 0; k < calls; ++k)
+    {
+      inputs[k % n] += 1e-9;
+      once(inputs);
+      sum += out[k % out.size()];
+    }
+    auto stop = std::chrono::steady_clock::now();
+    if (sum == 42.0) // keep the calls alive
+      std::println("");
+    best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(calls));
+  }
+  return best;
+}
+
+int main(int argc, char** argv)
+{
+  const std::size_t calls = argc > 1 ? std::stoull(argv[1]) : 2'000'000;
+  std::println("{:>8} {:>12} {:>9}", "method", "ns/call", "entries");
+
+#if defined(LAM_BENCH_PACKED)
+  {
+    const auto kernel = [&]<std::size_t... Ks>(std::index_sequence<Ks...>) {
+      return compile(hessian(loss, variable<Ks>{}...), variable<Ks>{}...);
+    }(std::make_index_sequence<n>{});
+    std::array<double, decltype(kernel)::packed_size> out{};
+    const double ns = ns_per_call([&](const auto& inputs) { call_packed(kernel, out, inputs); }, out, calls);
+    std::println("{:>8} {:>12.2f} {:>9}", "packed", ns, decltype(kernel)::nonzeros);
+  }
+#endif
+
+#if defined(LAM_BENCH_NAIVE)
+  {
+    const auto kernels = []<std::size_t... Ks>(std::index_sequence<Ks...>) {
+      return std::make_tuple([]<std::size_t I, std::size_t J>(std::integral_constant<std::size_t, I>,
+                                                              std::integral_constant<std::size_t, J>) {
+        return []<std::size_t... Vs>(std::index_sequence<Vs...>) {
+          return compile(derivative(derivative(loss, variable<I>{}), variable<J>{}), variable<Vs>{}...);
+        }(std::make_index_sequence<n>{});
+      }(std::integral_constant<std::size_t, Ks / n>{}, std::integral_constant<std::size_t, Ks % n>{})...);
+    }(std::make_index_sequence<n * n>{});
+    std::array<double, n * n> out{};
+    const double ns = ns_per_call([&](const auto& inputs) { call_naive(kernels, out, inputs); }, out, calls);
+    std::println("{:>8} {:>12.2f} {:>9}", "naive", ns, n * n);
+  }
+#endif
+
+  return 0;
+}
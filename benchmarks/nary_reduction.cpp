@@ -0,0 +1,122 @@
+/*
+ * nary_reduction.cpp
+ * Benchmark for lam.symbols
+ * Latency and accuracy of flattened 8, 32 and 128 term sums evaluated as a
+ * left fold (default), balanced (balance) and compensated (compensate).
+ *
+ * usage: bench_nary_reduction [repetitions]
+ *
+ * Author: Colin Ford
+ * License: CC0-1.0 Universal
+ */
+
+import std;
+import lam.symbols;
+
+using namespace lam::symbols;
+
+template<std::size_t I>
+struct term_tag
+{};
+template<std::size_t I>
+using term = symbol<unconstrained, symbol_id<term_tag<I>>{}>;
+
+// x0 + x1 + ... + x(N-1), one flattened N-ary sum
+template<std::size_t N>
+constexpr auto make_sum()
+{
+  return []<std::size_t... Is>(std::index_sequence<Is...>) { return (... + term<Is>{}); }(std::make_index_sequence<N>{});
+}
+
+template<std::size_t N, typename Expression>
+constexpr auto compile_sum(const Expression& expr)
+{
+  return [&]<std::size_t... Is>(std::index_sequence<Is...>) { return compile(expr, term<Is>{}...); }(
+    std::make_index_sequence<N>{});
+}
+
+// Feeds each result back into the first operand: the time per call is the critical path
+template<typename Kernel, std::size_t N>
+double latency_ns(const Kernel& kernel, std::array<double, N> values, std::size_t repetitions)
+{
+  const double first = values[0];
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t r = 0; r < repetitions; ++r)
+    values[0] = first + kernel(values) * 0x1p-80;
+  auto stop = std::chrono::steady_clock::now();
+  if (values[0] == 42.0) // keep the chain alive
+    std::println("");
+  return std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(repetitions);
+}
+
+// Exact enough reference: long double Neumaier summation
+template<std::size_t N>
+long double reference_sum(const std::array<double, N>& values)
+{
+  long double sum = 0.0L;
+  long double correction = 0.0L;
+  for (double v : values)
+  {
+    const long double x = v;
+    const long double total = sum + x;
+    if (std::abs(sum) >= std::abs(x))
+      correction += (sum - total) + x;
+    else
+      correction += (x - total) + sum;
+    sum = total;
+  }
+  return sum + correction;
+}
+
+template<std::size_t N>
+void run(std::size_t repetitions)
+{
+  constexpr auto sum = make_sum<N>();
+  constexpr auto left_fold = compile_sum<N>(sum);
+  constexpr auto balanced = compile_sum<N>(balance(sum));
+  constexpr auto compensated = compile_sum<N>(compensate(sum));
+
+  std::mt19937_64 rng(N);
+  std::normal_distribution<double> mantissa(0.0, 1.0);
+  std::uniform_real_distribution<double> exponent(-8.0, 8.0);
+  auto random_values = [&] {
+    std::array<double, N> values{};
+    for (auto& v : values)
+      v = mantissa(rng) * std::pow(10.0, exponent(rng));
+    return values;
+  };
+
+  // accuracy: relative error against the reference, worst and mean over many sums
+  constexpr std::size_t trials = 10000;
+  std::array<double, 3> worst{}, mean{};
+  for (std::size_t t = 0; t < trials; ++t)
+  {
+    const auto values = random_values();
+    const long double exact = reference_sum(values);
+    const std::array<double, 3> got{left_fold(values), balanced(values), compensated(values)};
+    for (std::size_t k = 0; k < 3; ++k)
+    {
+      const double error = static_cast<double>(std::abs((got[k] - exact) / exact));
+      worst[k] = std::max(worst[k], error);
+      mean[k] += error / trials;
+    }
+  }
+
+  const auto values = random_values();
+  const std::array<double, 3> latency{latency_ns(left_fold, values, repetitions),
+                                      latency_ns(balanced, values, repetitions),
+                                      latency_ns(compensated, values, repetitions)};
+  constexpr std::array<std::string_view, 3> names{"left fold", "balanced", "compensated"};
+  for (std::size_t k = 0; k < 3; ++k)
+    std::println("{:>5} {:>12} {:>12.2f} ns {:>14.3e} {:>14.3e}", N, names[k], latency[k], worst[k], mean[k]);
+}
+
+int main(int argc, char** argv)
+{
+  const std::size_t repetitions = argc > 1 ? std::stoull(argv[1]) : 10'000'000;
+  std::println("{:>5} {:>12} {:>15} {:>14} {:>14}", "terms", "evaluation", "latency", "worst rel err", "mean rel err");
+  run<8>(repetitions);
+  run<32>(repetitions);
+  run<128>(repetitions / 4);
+  return 0;
+}
@@ -0,0 +1,77 @@
+/*
+ * parallel_scaling.cpp
+ * Benchmark for lam.symbols
+ * Strong scaling of policy-driven batch evaluation from 1 to N threads on the
+ * orbital accelerations of examples/orbital-motion (with r^3 folded in).
+ *
+ * usage: bench_parallel_scaling [points] [max_threads]
+ *
+ * Author: Colin Ford
+ * License: CC0-1.0 Universal
+ */
+
+import std;
+import lam.symbols;
+
+using namespace lam::symbols;
+
+constexpr symbol pos_x;
+constexpr symbol pos_y;
+constexpr symbol gm;
+
+constexpr auto r2 = pos_x * pos_x + pos_y * pos_y;
+constexpr auto ax_symbolic = -gm * pos_x / (r2 ^ 1.5);
+constexpr auto ay_symbolic = -gm * pos_y / (r2 ^ 1.5);
+
+template<typename Policy>
+double time_ms(const Policy& policy, std::span<double> ax, std::span<double> ay, std::span<const double> xs,
+               std::span<const double> ys, int repetitions)
+{
+  double best = std::numeric_limits<double>::max();
+  for (int rep = 0; rep < repetitions; ++rep)
+  {
+    auto start = std::chrono::steady_clock::now();
+    evaluate_batch(policy, ax_symbolic, ax, pos_x = xs, pos_y = ys, gm = 1.0);
+    evaluate_batch(policy, ay_symbolic, ay, pos_x = xs, pos_y = ys, gm = 1.0);
+    auto stop = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double, std::milli>(stop - start).count());
+  }
+  return best;
+}
+
+int main(int argc, char** argv)
+{
+  const std::size_t points = argc > 1 ? std::stoull(argv[1]) : 10'000'000;
+  const std::size_t max_threads =
+    argc > 2 ? std::stoull(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+  constexpr int repetitions = 5;
+
+  std::vector<double> xs(points), ys(points), ax(points), ay(points);
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<double> dist(0.5, 2.0);
+  for (std::size_t i = 0; i < points; ++i)
+  {
+    xs[i] = dist(rng);
+    ys[i] = dist(rng);
+  }
+
+  std::println("points: {}, best of {} runs", points, repetitions);
+  const double seq_ms = time_ms(execution::seq, ax, ay, xs, ys, repetitions);
+  const double unseq_ms = time_ms(execution::unseq, ax, ay, xs, ys, repetitions);
+  std::println("{:>10} {:>12.3f} ms", "seq", seq_ms);
+  std::println("{:>10} {:>12.3f} ms  ({:.2f}x vs seq)", "unseq", unseq_ms, seq_ms / unseq_ms);
+
+  std::println("{:>10} {:>15} {:>10} {:>12}", "threads", "par_unseq (ms)", "speedup", "efficiency");
+  for (std::size_t threads = 1; threads <= max_threads; threads = threads < 4 ? threads + 1 : threads * 2)
+  {
+    thread_pool pool(threads);
+    const double ms = time_ms(execution::par_unseq.on(pool), ax, ay, xs, ys, repetitions);
+    const double speedup = unseq_ms / ms;
+    std::println("{:>10} {:>15.3f} {:>9.2f}x {:>11.1f}%", threads, ms, speedup,
+                 100.0 * speedup / static_cast<double>(threads));
+  }
+
+  // keep the results alive
+  std::println("checksum: {}", std::reduce(ax.begin(), ax.end()) + std::reduce(ay.begin(), ay.end()));
+  return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * polynomial_schemes.cpp
+ * Benchmark for lam.symbols
+ * Flattened sums of c_k * x^k of degree 4 to 20 evaluated term by term
+ * (default), in Horner form (horner) and in Estrin form (estrin). Latency
+ * feeds every result into the next x; throughput evaluates independent points.
+ *
+ * usage: bench_polynomial_schemes [repetitions]
+ *
+ * Author: Colin Ford
+ * License: CC0-1.0 Universal
+ */
+
+import std;
+import lam.symbols;
+
+using namespace lam::symbols;
+
+constexpr symbol x;
+
+// sum of c_k * x^k, c_k = (-1)^k / (k + 1)
+template<int Degree>
+constexpr auto make_polynomial()
+{
+  return []<int... Ks>(std::integer_sequence<int, Ks...>) {
+    return (... + ((Ks % 2 ? -1.0 : 1.0) / (Ks + 1) * (x ^ constant_symbol<Ks>{})));
+  }(std::make_integer_sequence<int, Degree + 1>{});
+}
+
+// Feeds each result back into x: the time per call is the critical path
+template<typename Kernel>
+double latency_ns(const Kernel& kernel, double first, std::size_t repetitions)
+{
+  double value = first;
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t r = 0; r < repetitions; ++r)
+    value = first + kernel(value) * 0x1p-60;
+  auto stop = std::chrono::steady_clock::now();
+  if (value == 42.0) // keep the chain alive
+    std::println("");
+  return std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(repetitions);
+}
+
+template<typename Kernel>
+double throughput_ns(const Kernel& kernel, std::span<const double> xs, std::span<double> out, std::size_t repetitions)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t r = 0; r < repetitions; ++r)
+    evaluate_batch(kernel, out, xs);
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(stop - start).count() /
+         static_cast<double>(repetitions * xs.size());
+}
+
+template<int Degree>
+void run(std::size_t repetitions, std::span<const double> xs, std::span<double> out)
+{
+  constexpr auto polynomial = make_polynomial<Degree>();
+  constexpr auto term_by_term = compile(polynomial, x);
+  constexpr auto horner_form = compile(horner(polynomial, x), x);
+  constexpr auto estrin_form = compile(estrin(polynomial, x), x);
+
+  const std::size_t batches = repetitions / xs.size();
+  std::println("{:>6} {:>10.2f} {:>10.2f} {:>10.2f} {:>10.3f} {:>10.3f} {:>10.3f}", Degree,
+               latency_ns(term_by_term, xs[0], repetitions), latency_ns(horner_form, xs[0], repetitions),
+               latency_ns(estrin_form, xs[0], repetitions), throughput_ns(term_by_term, xs, out, batches),
+               throughput_ns(horner_form, xs, out, batches), throughput_ns(estrin_form, xs, out, batches));
+}
+
+int main(int argc, char** argv)
+{
+  const std::size_t repetitions = argc > 1 ? std::stoull(argv[1]) : 10'000'000;
+  std::vector<double> xs(4096), out(4096);
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  for (auto& v : xs)
+    v = dist(rng);
+
+  std::println("{:>6} {:>32} {:>32}", "", "latency (ns/call)", "throughput (ns/point)");
+  std::println("{:>6} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10}", "degree", "terms", "horner", "estrin", "terms",
+               "horner", "estrin");
+  run<4>(repetitions, xs, out);
+  run<8>(repetitions, xs, out);
+  run<12>(repetitions, xs, out);
+  run<16>(repetitions, xs, out);
+  run<20>(repetitions, xs, out);
+  return 0;
+}
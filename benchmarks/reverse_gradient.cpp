@@ -0,0 +1,110 @@
+/*
+ * reverse_gradient.cpp
+ * Benchmark for lam.symbols
+ * Chained Rosenbrock loss over N symbols, sum of 100 (x[i+1] - x[i]^2)^2 +
+ * (1 - x[i])^2: one evaluation (compile), value and gradient in reverse mode
+ * (gradient), and the gradient as a one row Jacobian (jacobian, forward
+ * symbolic differentiation, only for the smaller N).
+ *
+ * usage: bench_reverse_gradient [calls]
+ *
+ * Author: Colin Ford
+ * License: CC0-1.0 Universal
+ */
+
+import std;
+import lam.symbols;
+
+using namespace lam::symbols;
+
+template<std::size_t K>
+struct variable_tag
+{};
+template<std::size_t K>
+using variable = symbol<unconstrained, symbol_id<variable_tag<K>>{}>;
+
+template<std::size_t N>
+constexpr auto make_loss()
+{
+  return []<std::size_t... Is>(std::index_sequence<Is...>) {
+    return (... + (constant_symbol<100>{} * ((variable<Is + 1>{} - (variable<Is>{} ^ constant_symbol<2>{})) ^
+                                              constant_symbol<2>{}) +
+                   ((constant_symbol<1>{} - variable<Is>{}) ^ constant_symbol<2>{})));
+  }(std::make_index_sequence<N - 1>{});
+}
+
+template<std::size_t N, typename Kernel>
+[[gnu::noinline]] auto call(const Kernel& kernel, const std::array<double, N>& inputs)
+{ return std::apply(kernel, inputs); }
+
+template<std::size_t N, typename Kernel>
+[[gnu::noinline]] void call_dense(const Kernel& kernel, std::span<double, N> out, const std::array<double, N>& inputs)
+{ std::apply([&](auto... values) { kernel.dense(out, values...); }, inputs); }
+
+// Best of five runs; one input changes per call so nothing is hoisted
+template<std::size_t N, typename Call>
+double ns_per_call(const Call& once, std::size_t calls)
+{
+  double best = std::numeric_limits<double>::max();
+  for (int run = 0; run < 5; ++run)
+  {
+    std::array<double, N> inputs{};
+    for (std::size_t i = 0; i < N; ++i)
+      inputs[i] = 0.5 + 0.01 * static_cast<double>(i);
+    double sum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t k = 0; k < calls; ++k)
+    {
+      inputs[k % N] += 1e-9;
+      sum += once(inputs);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    if (sum == 42.0) // keep the calls alive
+      std::println("");
+    best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(calls));
+  }
+  return best;
+}
+
+template<std::size_t N, bool Forward>
+void run(std::size_t calls)
+{
+  constexpr auto loss = make_loss<N>();
+  const auto [value_ns, gradient_ns] = [&]<std::size_t... Ks>(std::index_sequence<Ks...>) {
+    const auto value = compile(loss, variable<Ks>{}...);
+    const auto reverse = gradient(loss, variable<Ks>{}...);
+    return std::pair{ns_per_call<N>([&](const auto& inputs) { return call<N>(value, inputs); }, calls),
+                     ns_per_call<N>([&](const auto& inputs) { return call<N>(reverse, inputs).gradient[0]; }, calls)};
+  }(std::make_index_sequence<N>{});
+  std::print("{:>6} {:>12.2f} {:>12.2f} {:>9.2f}x", N, value_ns, gradient_ns, gradient_ns / value_ns);
+
+  if constexpr (Forward)
+  {
+    const double forward_ns = [&]<std::size_t... Ks>(std::index_sequence<Ks...>) {
+      const auto kernel = compile(jacobian(std::tuple{loss}, variable<Ks>{}...), variable<Ks>{}...);
+      std::array<double, N> out{};
+      return ns_per_call<N>(
+        [&](const auto& inputs) {
+          call_dense<N>(kernel, std::span<double, N>(out), inputs);
+          return out[0];
+        },
+        calls);
+    }(std::make_index_sequence<N>{});
+    std::println(" {:>12.2f} {:>9.2f}x", forward_ns, forward_ns / value_ns);
+  }
+  else
+    std::println(" {:>12} {:>10}", "-", "-");
+}
+
+int main(int argc, char** argv)
+{
+  const std::size_t calls = argc > 1 ? std::stoull(argv[1]) : 2'000'000;
+  std::println("{:>6} {:>12} {:>12} {:>10} {:>12} {:>10}", "N", "value", "gradient", "/ value", "jacobian",
+               "/ value");
+  std::println("{:>6} {:>12} {:>12} {:>10} {:>12} {:>10}", "", "(ns/call)", "(ns/call)", "", "(ns/call)", "");
+  run<4, true>(calls);
+  run<10, true>(calls);
+  run<32, true>(calls);
+  run<100, false>(calls);
+  return 0;
+}
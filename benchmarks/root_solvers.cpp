@@ -0,0 +1,128 @@
+/*
+ * root_solvers.cpp
+ * Benchmark for lam.symbols
+ * Kepler's equation E - e sin(E) - M = 0 over a column of mean anomalies:
+ * Newton iterations with f and f' compiled separately (separate), with the
+ * fused bundle of newton_solver (newton), and halley_solver (halley).
+ *
+ * usage: bench_root_solvers [lanes]
+ *
+ * Author: Colin Ford
+ * License: CC0-1.0 Universal
+ */
+
+import std;
+import lam.symbols;
+
+using namespace lam::symbols;
+
+constexpr symbol E;
+constexpr symbol e;
+constexpr symbol M;
+
+struct SinOp
+{
+  template<typename T>
+  constexpr auto operator()(const T& arg) const
+  { return std::sin(arg); }
+};
+struct CosOp
+{
+  template<typename T>
+  constexpr auto operator()(const T& arg) const
+  { return std::cos(arg); }
+};
+
+template<typename Expr>
+constexpr auto sin(const Expr& expr)
+{ return symbolic_expression<SinOp, Expr>{expr}; }
+template<typename Expr>
+constexpr auto cos(const Expr& expr)
+{ return symbolic_expression<CosOp, Expr>{expr}; }
+
+template<>
+struct lam::symbols::unary_derivative<SinOp>
+{
+  template<typename Arg>
+  constexpr auto operator()(const Arg& u) const
+  { return cos(u); }
+};
+template<>
+struct lam::symbols::unary_derivative<CosOp>
+{
+  template<typename Arg>
+  constexpr auto operator()(const Arg& u) const
+  { return -sin(u); }
+};
+
+constexpr auto kepler = E - e * sin(E) - M;
+
+// Best of five runs, in ns per lane; the first guess of each lane is its mean anomaly
+template<typename Solve>
+double ns_per_lane(const Solve& solve, const std::vector<double>& anomalies)
+{
+  double best = std::numeric_limits<double>::max();
+  std::vector<double> roots(anomalies.size());
+  for (int run = 0; run < 5; ++run)
+  {
+    roots = anomalies;
+    auto start = std::chrono::steady_clock::now();
+    solve(roots);
+    auto stop = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count());
+  }
+  if (roots[0] == 42.0) // keep the roots alive
+    std::println("");
+  return best / static_cast<double>(anomalies.size());
+}
+
+int main(int argc, char** argv)
+{
+  const std::size_t lanes = argc > 1 ? std::stoull(argv[1]) : 1 << 20;
+  const double eccentricity = 0.3;
+  std::vector<double> anomalies(lanes);
+  for (std::size_t i = 0; i < lanes; ++i)
+    anomalies[i] = 6.28 * static_cast<double>(i) / static_cast<double>(lanes);
+
+  const auto newton = newton_solver(kepler, E, e, M);
+  const auto halley = halley_solver(kepler, E, e, M);
+  const auto f = compile(kepler, E, e, M);
+  const auto df = compile(derivative(kepler, E), E, e, M);
+
+  std::println("{:>10} {:>12}", "method", "ns/lane");
+  const auto report = [](const char* name, double ns) { std::println("{:>10} {:>12.2f}", name, ns); };
+  report("separate", ns_per_lane(
+                       [&](std::vector<double>& roots) {
+                         for (std::size_t i = 0; i < roots.size(); ++i)
+                         {
+                           for (std::size_t k = 1; k <= newton.max_iterations; ++k)
+                           {
+                             const double delta = f(roots[i], eccentricity, anomalies[i]) /
+                                                  df(roots[i], eccentricity, anomalies[i]);
+                             roots[i] -= delta;
+                             if (std::abs(delta) <= newton.tolerance * std::max(1.0, std::abs(roots[i])))
+                               break;
+                           }
+                         }
+                       },
+                       anomalies));
+  report("newton", ns_per_lane(
+                     [&](std::vector<double>& roots) {
+                       for (std::size_t i = 0; i < roots.size(); ++i)
+                         roots[i] = newton(roots[i], eccentricity, anomalies[i]).root;
+                     },
+                     anomalies));
+  report("halley", ns_per_lane(
+                     [&](std::vector<double>& roots) {
+                       for (std::size_t i = 0; i < roots.size(); ++i)
+                         roots[i] = halley(roots[i], eccentricity, anomalies[i]).root;
+                     },
+                     anomalies));
+  std::vector<char> converged(lanes);
+  report("batched", ns_per_lane(
+                      [&](std::vector<double>& roots) {
+                        halley.solve_batch(roots, converged, eccentricity, anomalies);
+                      },
+                      anomalies));
+  return 0;
+}
@@ -0,0 +1,110 @@
+/*
+ * sparse_jacobian.cpp
+ * Benchmark for lam.symbols
+ * Jacobian of a tridiagonal system of n = 24 equations over 24 symbols,
+ * f[i] = x[i-1] - 2 x[i] + x[i+1] + x[i]^2, in forward mode: every symbol
+ * along its own tangent, dual<double, 24> (dense), against the 3 colors of
+ * jacobian_sparsity, dual<double, 3> (colored).
+ *
+ * usage: bench_sparse_jacobian [calls]
+ *
+ * Author: Colin Ford
+ * License: CC0-1.0 Universal
+ */
+
+import std;
+import lam.symbols;
+
+using namespace lam::symbols;
+
+constexpr std::size_t n = 24;
+
+template<std::size_t K>
+struct variable_tag
+{};
+template<std::size_t K>
+using variable = symbol<unconstrained, symbol_id<variable_tag<K>>{}>;
+
+template<std::size_t I>
+constexpr auto equation()
+{
+  constexpr auto centre = constant_symbol<-2>{} * variable<I>{} + (variable<I>{} ^ constant_symbol<2>{});
+  if constexpr (I == 0)
+    return centre + variable<I + 1>{};
+  else if constexpr (I == n - 1)
+    return variable<I - 1>{} + centre;
+  else
+    return variable<I - 1>{} + centre + variable<I + 1>{};
+}
+
+constexpr auto equations = []<std::size_t... Is>(std::index_sequence<Is...>) {
+  return formula_bundle{equation<Is>()...};
+}(std::make_index_sequence<n>{});
+
+using pattern = decltype([]<std::size_t... Is>(std::index_sequence<Is...>) {
+  return sparsity_pattern(equations, variable<Is>{}...);
+}(std::make_index_sequence<n>{}));
+
+// Every symbol seeded along its own tangent, the nonzeros gathered in CSR order
+template<typename Kernel>
+[[gnu::noinline]] void call_dense(const Kernel& kernel, std::span<double> out, const std::array<double, n>& inputs)
+{
+  const auto results = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+    return kernel(seed_dual<n>(inputs[Is], Is)...);
+  }(std::make_index_sequence<n>{});
+  [&]<std::size_t... Rs>(std::index_sequence<Rs...>) {
+    (
+      [&]<std::size_t R>(std::integral_constant<std::size_t, R>) {
+        for (std::size_t k = pattern::row_offsets[R]; k < pattern::row_offsets[R + 1]; ++k)
+          out[k] = std::get<R>(results).tangent[pattern::column_indices[k]];
+      }(std::integral_constant<std::size_t, Rs>{}),
+      ...);
+  }(std::make_index_sequence<n>{});
+}
+
+template<typename Kernel>
+[[gnu::noinline]] void call_colored(const Kernel& kernel, std::span<double> out, const std::array<double, n>& inputs)
+{ colored_jacobian(kernel, inputs, out); }
+
+// Best of five runs; one input changes per call so nothing is hoisted
+template<typename Call>
+double ns_per_call(const Call& once, std::span<double> out, std::size_t calls)
+{
+  double best = std::numeric_limits<double>::max();
+  for (int run = 0; run < 5; ++run)
+  {
+    std::array<double, n> inputs{};
+    for (std::size_t i = 0; i < n; ++i)
+      inputs[i] = 0.5 + 0.01 * static_cast<double>(i);
+    double sum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t k = 0; k < calls; ++k)
+    {
+      inputs[k % n] += 1e-9;
+      once(inputs);
+      sum += out[k % out.size()];
+    }
+    auto stop = std::chrono::steady_clock::now();
+    if (sum == 42.0) // keep the calls alive
+      std::println("");
+    best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(calls));
+  }
+  return best;
+}
+
+int main(int argc, char** argv)
+{
+  const std::size_t calls = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+  const auto kernel = []<std::size_t... Is>(std::index_sequence<Is...>) {
+    return compile(equations, variable<Is>{}...);
+  }(std::make_index_sequence<n>{});
+  std::array<double, pattern::nonzeros> out{};
+
+  std::println("{:>8} {:>12} {:>9}", "method", "ns/call", "tangents");
+  std::println("{:>8} {:>12.2f} {:>9}", "dense",
+               ns_per_call([&](const auto& inputs) { call_dense(kernel, out, inputs); }, out, calls), n);
+  std::println("{:>8} {:>12.2f} {:>9}", "colored",
+               ns_per_call([&](const auto& inputs) { call_colored(kernel, out, inputs); }, out, calls),
+               pattern::color_count);
+  return 0;
+}
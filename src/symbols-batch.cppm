@@ -0,0 +1,118 @@
+/*
+ * Provided under CC0 1.0 Universal – Public Domain Dedication license
+ * Original Author: Vincent Reverdy (LAPP, France)
+ * Source: CppCon 2023 "Symbolic Calculus for High-performance Computing From Scratch Using C++23"
+ */
+
+/*
+ * lam.symbols:batch
+ * Description: Evaluation of one expression over many points at once.
+ * Content: evaluate_batch over structure-of-arrays inputs (spans, vectors, arrays),
+ *          with scalar binders broadcast to every point.
+ * Extending Author: Colin Ford
+ */
+
+module;
+
+#include "symbols-vectorize.hpp"
+
+import std;
+
+export module lam.symbols:batch;
+import :traits;
+import :core;
+import :engine;
+
+export namespace lam::symbols
+{
+
+/*
+ *  Batch Inputs
+ *  A column is a contiguous, sized range holding one value per point.
+ *  Anything else bound to a symbol is a scalar and is broadcast.
+ */
+
+template<typename T>
+concept batch_column = std::ranges::contiguous_range<T> && std::ranges::sized_range<T>;
+
+template<typename T>
+concept batch_output = batch_column<T> && std::is_lvalue_reference_v<std::ranges::range_reference_t<T>> &&
+                       !std::is_const_v<std::remove_reference_t<std::ranges::range_reference_t<T>>>;
+
+// Lane access inside the loop: a raw pointer for columns, the value itself for scalars
+template<typename T>
+struct column_source
+{
+  const T* data;
+  constexpr const T& operator[](std::size_t i) const noexcept { return data[i]; }
+};
+
+template<typename T>
+struct broadcast_source
+{
+  T value;
+  constexpr const T& operator[](std::size_t) const noexcept { return value; }
+};
+
+template<typename Input>
+constexpr auto make_batch_source(const Input& input) noexcept
+{
+  if constexpr (batch_column<Input>)
+    return column_source<std::ranges::range_value_t<Input>>{std::ranges::data(input)};
+  else
+    return broadcast_source<Input>{input};
+}
+
+// Points [first, last) of a compiled kernel, one source per kernel symbol
+template<bool Vectorize = true, typename Kernel, typename T, typename... Sources>
+constexpr void evaluate_batch_range(const Kernel& kernel, T* out, std::size_t first, std::size_t last,
+                                    const Sources&... sources) noexcept
+{
+  using result_type = decltype(kernel(sources[0]...));
+  static_assert(!is_symbolic_v<result_type>, "evaluate_batch: every symbol of the expression must be bound");
+
+  if constexpr (Vectorize)
+  {
+    LAM_SYMBOLS_VECTORIZE_LOOP
+    for (std::size_t i = first; i < last; ++i)
+      out[i] = static_cast<T>(kernel(sources[i]...));
+  }
+  else
+  {
+    for (std::size_t i = first; i < last; ++i)
+      out[i] = static_cast<T>(kernel(sources[i]...));
+  }
+}
+
+/*
+ *  evaluate_batch
+ *  evaluate_batch(expr, out, x = xs, y = ys, gm = 1.0) writes expr at every
+ *  point i to out[i], reading xs[i], ys[i] and broadcasting gm.
+ *  Precondition: every column holds at least std::ranges::size(out) values.
+ *  The loop body is the fully inlined positional kernel, so it vectorizes as
+ *  long as the expression itself maps to vector instructions.
+ */
+
+// Positional form: one input (column or scalar) per symbol of the compiled kernel
+template<symbolic Expression, typename... Symbols, batch_output Output, typename... Inputs>
+  requires(sizeof...(Inputs) == sizeof...(Symbols))
+constexpr void evaluate_batch(const compiled_formula<Expression, Symbols...>& kernel, Output&& out,
+                              const Inputs&... inputs) noexcept
+{
+  evaluate_batch_range(kernel, std::ranges::data(out), 0, std::ranges::size(out), make_batch_source(inputs)...);
+}
+
+// Binder form: evaluate_batch(expr, out, x = xs, y = ys, ...)
+template<symbolic Expression, batch_output Output, typename... Binders>
+constexpr void evaluate_batch(const Expression& expr, Output&& out, const Binders&... binders) noexcept
+{
+  evaluate_batch(compile(expr, std::remove_cvref_t<Binders>::symbol...), std::forward<Output>(out), binders()...);
+}
+
+template<symbolic Expression, batch_output Output, typename... Binders>
+constexpr void evaluate_batch(const formula<Expression>& f, Output&& out, const Binders&... binders) noexcept
+{
+  evaluate_batch(f.expression, std::forward<Output>(out), binders...);
+}
+
+} // end namespace lam::symbols
@@ -0,0 +1,431 @@
+/*
+ * Provided under CC0 1.0 Universal – Public Domain Dedication license
+ * Original Author: Vincent Reverdy (LAPP, France)
+ * Source: CppCon 2023 "Symbolic Calculus for High-performance Computing From Scratch Using C++23"
+ */
+
+/*
+ * lam.symbols:bundle
+ * Description: Several formulas evaluated together, sharing common subexpressions.
+ * Content: formula_bundle, common subexpression detection (type based),
+ *          compiled_bundle and evaluate_batch into a tuple of outputs.
+ * Extending Author: Colin Ford
+ */
+
+module;
+
+#include "symbols-vectorize.hpp"
+
+import std;
+
+export module lam.symbols:bundle;
+import :traits;
+import :core;
+import :engine;
+import :batch;
+
+export namespace lam::symbols
+{
+
+/*
+ *  Type Lists
+ */
+
+template<typename... Ts>
+struct type_list
+{};
+
+template<typename T, typename List>
+constexpr bool type_list_contains_v = false;
+template<typename T, typename... Ts>
+constexpr bool type_list_contains_v<T, type_list<Ts...>> = (std::is_same_v<T, Ts> || ...);
+
+// Index of the first T in the list (the list size if absent)
+template<typename T, typename List>
+constexpr std::size_t type_list_index_v = 0;
+template<typename T, typename... Ts>
+constexpr std::size_t type_list_index_v<T, type_list<Ts...>> = [] {
+  std::size_t found = sizeof...(Ts);
+  std::size_t i = 0;
+  ((std::is_same_v<T, Ts> && found == sizeof...(Ts) ? (found = i) : 0, ++i), ...);
+  return found;
+}();
+
+// Occurrences of T in the list
+template<typename T, typename List>
+constexpr std::size_t type_list_count_v = 0;
+template<typename T, typename... Ts>
+constexpr std::size_t type_list_count_v<T, type_list<Ts...>> = (std::size_t{std::is_same_v<T, Ts>} + ... + 0);
+
+template<typename List>
+constexpr std::size_t type_list_size_v = 0;
+template<typename... Ts>
+constexpr std::size_t type_list_size_v<type_list<Ts...>> = sizeof...(Ts);
+
+template<typename List>
+struct type_list_reverse;
+template<>
+struct type_list_reverse<type_list<>>
+{ using type = type_list<>; };
+template<typename T, typename... Ts>
+struct type_list_reverse<type_list<T, Ts...>>
+{
+  template<typename List>
+  struct append;
+  template<typename... Us>
+  struct append<type_list<Us...>>
+  { using type = type_list<Us..., T>; };
+  using type = typename append<typename type_list_reverse<type_list<Ts...>>::type>::type;
+};
+
+/*
+ *  Common Subexpression Detection
+ *  Two subtrees are the same value exactly when are_same_symbolic_value_v
+ *  holds: same type, no runtime data. Only such expressions are shared; a
+ *  subtree holding a double literal is recomputed wherever it appears.
+ */
+
+template<typename T>
+constexpr bool is_shareable_subexpression_v =
+  is_symbolic_expression<std::remove_cvref_t<T>>::value && is_stateless_v<T>;
+
+// Distinct shareable subtrees of Trees..., children before parents
+template<typename List, typename... Trees>
+struct collect_subexpressions
+{ using type = List; };
+
+template<typename List, typename Tree>
+struct collect_subexpressions_of
+{ using type = List; };
+template<typename List, typename Op, typename... Terms>
+struct collect_subexpressions_of<List, symbolic_expression<Op, Terms...>>
+{
+  using expr = symbolic_expression<Op, Terms...>;
+  using children = typename collect_subexpressions<List, Terms...>::type;
+
+  template<typename L>
+  struct append_self;
+  template<typename... Ts>
+  struct append_self<type_list<Ts...>>
+  {
+    using type = std::conditional_t<is_shareable_subexpression_v<expr> && !type_list_contains_v<expr, type_list<Ts...>>,
+                                    type_list<Ts..., expr>, type_list<Ts...>>;
+  };
+  using type = typename append_self<children>::type;
+};
+
+template<typename List, typename Tree, typename... Rest>
+struct collect_subexpressions<List, Tree, Rest...>
+{
+  using type = typename collect_subexpressions<typename collect_subexpressions_of<List, Tree>::type, Rest...>::type;
+};
+
+// Occurrences of T in Tree, not looking inside the subtrees listed in Stops
+template<typename T, typename Stops, typename Tree>
+struct subexpression_uses : std::integral_constant<std::size_t, 0>
+{};
+template<typename T, typename Stops, typename Op, typename... Terms>
+struct subexpression_uses<T, Stops, symbolic_expression<Op, Terms...>>
+{
+  using expr = symbolic_expression<Op, Terms...>;
+  static constexpr std::size_t value = [] {
+    if constexpr (std::is_same_v<T, expr>)
+      return std::size_t{1};
+    else if constexpr (type_list_contains_v<expr, Stops>)
+      return std::size_t{0};
+    else
+      return (std::size_t{0} + ... + subexpression_uses<T, Stops, Terms>::value);
+  }();
+};
+
+// Occurrences of T in the operands of a shared subtree (its body is evaluated once)
+template<typename T, typename Stops, typename Shared>
+struct subexpression_body_uses;
+template<typename T, typename Stops, typename Op, typename... Terms>
+struct subexpression_body_uses<T, Stops, symbolic_expression<Op, Terms...>>
+  : std::integral_constant<std::size_t, (0 + ... + subexpression_uses<T, Stops, Terms>::value)>
+{};
+
+// Walk the candidates parents first. A candidate is shared when it is still used
+// twice once every already shared parent is replaced by its cached value:
+// in ((x+y)*z) used twice, (x+y) is computed once, inside the shared product.
+template<typename Shared, typename Outputs, typename Candidates>
+struct select_shared_subexpressions;
+template<typename... Shared, typename... Outputs>
+struct select_shared_subexpressions<type_list<Shared...>, type_list<Outputs...>, type_list<>>
+{ using type = type_list<Shared...>; };
+template<typename... Shared, typename... Outputs, typename T, typename... Rest>
+struct select_shared_subexpressions<type_list<Shared...>, type_list<Outputs...>, type_list<T, Rest...>>
+{
+  using stops = type_list<Shared...>;
+  static constexpr std::size_t uses = (0 + ... + subexpression_uses<T, stops, Outputs>::value) +
+                                      (0 + ... + subexpression_body_uses<T, stops, Shared>::value);
+  using type = typename select_shared_subexpressions<
+    std::conditional_t<(uses >= 2), type_list<Shared..., T>, type_list<Shared...>>, type_list<Outputs...>,
+    type_list<Rest...>>::type;
+};
+
+// The shared subtrees of Outputs..., children before parents (evaluation order)
+template<typename... Outputs>
+struct shared_subexpressions
+{
+  using candidates = typename collect_subexpressions<type_list<>, Outputs...>::type;
+  using parents_first = typename select_shared_subexpressions<type_list<>, type_list<Outputs...>,
+                                                              typename type_list_reverse<candidates>::type>::type;
+  using type = typename type_list_reverse<parents_first>::type;
+};
+template<typename... Outputs>
+using shared_subexpressions_t = typename shared_subexpressions<std::remove_cvref_t<Outputs>...>::type;
+
+/*
+ *  Rewriting
+ *  Every shared subtree is replaced by a reserved symbol; its value is bound
+ *  to that symbol once computed, like any other binder.
+ */
+
+template<std::size_t K>
+struct common_subexpression_tag
+{};
+
+template<std::size_t K>
+using common_subexpression_symbol = symbol<unconstrained, symbol_id<common_subexpression_tag<K>>{}>;
+
+// A stateless expression carries no data, so its type is enough to rebuild it
+template<typename T>
+constexpr auto make_stateless() noexcept
+{
+  if constexpr (is_symbolic_expression<T>::value)
+    return []<typename Op, typename... Terms>(std::type_identity<symbolic_expression<Op, Terms...>>) {
+      return symbolic_expression<Op, Terms...>(make_stateless<Terms>()...);
+    }(std::type_identity<T>{});
+  else
+    return T{};
+}
+
+template<typename Shared, typename Op, typename... Terms>
+constexpr auto replace_shared_operands(const symbolic_expression<Op, Terms...>& expr);
+
+template<typename Shared, typename Term>
+constexpr auto replace_shared(const Term& term)
+{
+  if constexpr (type_list_contains_v<Term, Shared>)
+    return common_subexpression_symbol<type_list_index_v<Term, Shared>>{};
+  else if constexpr (is_symbolic_expression<Term>::value)
+    return replace_shared_operands<Shared>(term);
+  else
+    return term;
+}
+
+// Rebuilds the node as is: the rewritten tree must not be simplified again
+template<typename Shared, typename Op, typename... Terms>
+constexpr auto replace_shared_operands(const symbolic_expression<Op, Terms...>& expr)
+{
+  return std::apply(
+    [](const auto&... terms) {
+      return symbolic_expression<Op, decltype(replace_shared<Shared>(terms))...>(replace_shared<Shared>(terms)...);
+    },
+    expr.terms);
+}
+
+// Substitution for the binder call: the caller's binders, then one binder per cached value
+template<typename... Args>
+struct common_subexpression_binders
+{
+  std::tuple<Args...> args;
+
+  template<typename... Cached>
+  constexpr auto operator()(const Cached&... cached) const
+  { return bind(std::index_sequence_for<Args...>{}, std::index_sequence_for<Cached...>{}, cached...); }
+
+  template<std::size_t... Is, std::size_t... Ks, typename... Cached>
+  constexpr auto bind(std::index_sequence<Is...>, std::index_sequence<Ks...>, const Cached&... cached) const
+  {
+    return substitution(std::get<Is>(args)..., symbol_binder<common_subexpression_symbol<Ks>, const Cached&>(
+                                                  common_subexpression_symbol<Ks>{}, cached)...);
+  }
+};
+
+// Substitution for the positional call: the cached values follow the positional values
+template<typename Symbols, typename... Values>
+struct common_subexpression_positions;
+template<typename... Symbols, typename... Values>
+struct common_subexpression_positions<std::tuple<Symbols...>, Values...>
+{
+  std::tuple<Values...> values;
+
+  template<typename... Cached>
+  constexpr auto operator()(const Cached&... cached) const
+  { return bind(std::index_sequence_for<Values...>{}, std::index_sequence_for<Cached...>{}, cached...); }
+
+  template<std::size_t... Is, std::size_t... Ks, typename... Cached>
+  constexpr auto bind(std::index_sequence<Is...>, std::index_sequence<Ks...>, const Cached&... cached) const
+  {
+    return positional_substitution<std::tuple<Symbols..., common_subexpression_symbol<Ks>...>, Values..., Cached...>(
+      std::get<Is>(values)..., cached...);
+  }
+};
+
+/*
+ *  formula_bundle
+ *  formula_bundle{ax, ay, energy} evaluates its outputs together and returns
+ *  them as a tuple. Every shared subtree is evaluated once per call, before
+ *  the outputs, in dependency order.
+ */
+
+template<symbolic... Outputs>
+  requires(sizeof...(Outputs) > 0)
+struct formula_bundle
+{
+  using shared_list = shared_subexpressions_t<Outputs...>;
+  static constexpr std::size_t size = sizeof...(Outputs);
+  static constexpr std::size_t shared_count = type_list_size_v<shared_list>;
+
+  // Shared subtrees with their own shared operands replaced, in evaluation order
+  static constexpr auto shared = []<typename... Shared>(type_list<Shared...>) {
+    return std::make_tuple(replace_shared_operands<shared_list>(make_stateless<Shared>())...);
+  }(shared_list{});
+
+  std::tuple<decltype(replace_shared<shared_list>(std::declval<const Outputs&>()))...> outputs;
+
+  constexpr formula_bundle(Outputs... o) : outputs(replace_shared<shared_list>(o)...) {}
+
+  // Binder call: bundle(x = 1.0, y = 2.0) returns std::tuple of every output
+  template<class... Args>
+  constexpr auto operator()(Args... args) const noexcept
+  {
+    return evaluate_with(common_subexpression_binders<Args...>{{args...}});
+  }
+
+  // Evaluates the shared subtrees in order; make(cached...) builds the substitution
+  // seen by the next one, holding the inputs and the values cached so far
+  template<std::size_t K = 0, typename Make, typename... Cached>
+  constexpr auto evaluate_with(const Make& make, const Cached&... cached) const
+  {
+    if constexpr (K == shared_count)
+    {
+      const auto s = make(cached...);
+      return std::apply([&](const auto&... output) { return std::make_tuple(output(s)...); }, outputs);
+    }
+    else
+    {
+      const auto value = std::get<K>(shared)(make(cached...));
+      return evaluate_with<K + 1>(make, cached..., value);
+    }
+  }
+};
+
+template<symbolic... Outputs>
+formula_bundle(Outputs...) -> formula_bundle<Outputs...>;
+
+// Inverse of replace_shared: every reserved symbol is replaced by the shared subtree it stands for
+template<typename Bundle, typename Term>
+constexpr auto restore_shared(const Term& term)
+{
+  if constexpr (is_symbolic_expression<Term>::value)
+    return std::apply(
+      [](const auto&... terms) {
+        return symbolic_expression<expr_op_t<Term>, decltype(restore_shared<Bundle>(terms))...>(
+          restore_shared<Bundle>(terms)...);
+      },
+      term.terms);
+  else
+  {
+    constexpr std::size_t k = [] {
+      std::size_t found = Bundle::shared_count;
+      [&]<std::size_t... Ks>(std::index_sequence<Ks...>) {
+        ((std::is_same_v<Term, common_subexpression_symbol<Ks>> ? void(found = Ks) : void()), ...);
+      }(std::make_index_sequence<Bundle::shared_count>{});
+      return found;
+    }();
+    if constexpr (k < Bundle::shared_count)
+      return restore_shared<Bundle>(std::get<k>(Bundle::shared));
+    else
+      return term;
+  }
+}
+
+// The outputs the bundle was built from, as a tuple
+template<symbolic... Outputs>
+constexpr std::tuple<Outputs...> expand_shared(const formula_bundle<Outputs...>& bundle)
+{
+  return std::apply(
+    [](const auto&... output) { return std::tuple<Outputs...>(restore_shared<formula_bundle<Outputs...>>(output)...); },
+    bundle.outputs);
+}
+
+/*
+ *  Compilation and Batch Evaluation
+ */
+
+template<typename Bundle, typename... Symbols>
+  requires(is_symbol_v<Symbols> && ...)
+struct compiled_bundle
+{
+  static_assert(are_distinct_types_v<Symbols...>, "compile: each symbol may only appear once");
+
+  using symbols_type = std::tuple<Symbols...>;
+  static constexpr std::size_t arity = sizeof...(Symbols);
+
+  Bundle bundle;
+
+  // Positional call: the cached values are appended to the positional values
+  template<typename... Values>
+    requires(sizeof...(Values) == arity)
+  constexpr auto operator()(Values... values) const noexcept
+  {
+    return bundle.evaluate_with(common_subexpression_positions<symbols_type, Values...>{{values...}});
+  }
+};
+
+template<symbolic... Outputs, typename... Symbols>
+  requires(is_symbol_v<Symbols> && ...)
+constexpr auto compile(const formula_bundle<Outputs...>& bundle, const Symbols&...) noexcept
+{
+  return compiled_bundle<formula_bundle<Outputs...>, std::remove_cvref_t<Symbols>...>{bundle};
+}
+
+// Points [first, last) of a compiled bundle, one output column per bundle output
+template<typename Kernel, typename... Ts, typename... Sources>
+constexpr void evaluate_batch_range(const Kernel& kernel, const std::tuple<Ts*...>& out, std::size_t first,
+                                    std::size_t last, const Sources&... sources) noexcept
+{
+  using result_type = decltype(kernel(sources[0]...));
+  static_assert(![]<typename... Rs>(std::type_identity<std::tuple<Rs...>>) {
+    return (is_symbolic_v<Rs> || ...);
+  }(std::type_identity<result_type>{}), "evaluate_batch: every symbol of the bundle must be bound");
+
+  LAM_SYMBOLS_VECTORIZE_LOOP
+  for (std::size_t i = first; i < last; ++i)
+  {
+    const auto values = kernel(sources[i]...);
+    [&]<std::size_t... Js>(std::index_sequence<Js...>) {
+      ((std::get<Js>(out)[i] = static_cast<Ts>(std::get<Js>(values))), ...);
+    }(std::index_sequence_for<Ts...>{});
+  }
+}
+
+/*
+ *  evaluate_batch(bundle, std::tie(ax, ay, energy), x = xs, y = ys, gm = 1.0)
+ *  Precondition: every column, input or output, holds at least
+ *  std::ranges::size of the first output values.
+ */
+
+template<typename Bundle, typename... Symbols, batch_output... Outs, typename... Inputs>
+  requires(sizeof...(Inputs) == sizeof...(Symbols) && sizeof...(Outs) == Bundle::size)
+constexpr void evaluate_batch(const compiled_bundle<Bundle, Symbols...>& kernel, std::tuple<Outs...> out,
+                              const Inputs&... inputs) noexcept
+{
+  const std::size_t count = std::ranges::size(std::get<0>(out));
+  auto data = std::apply([](auto&... o) { return std::make_tuple(std::ranges::data(o)...); }, out);
+  evaluate_batch_range(kernel, data, 0, count, make_batch_source(inputs)...);
+}
+
+template<symbolic... Outputs, batch_output... Outs, typename... Binders>
+  requires(sizeof...(Outs) == sizeof...(Outputs))
+constexpr void evaluate_batch(const formula_bundle<Outputs...>& bundle, std::tuple<Outs...> out,
+                              const Binders&... binders) noexcept
+{
+  evaluate_batch(compile(bundle, std::remove_cvref_t<Binders>::symbol...), out, binders()...);
+}
+
+} // end namespace lam::symbols
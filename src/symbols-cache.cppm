@@ -0,0 +1,256 @@
+/*
+ * Provided under CC0 1.0 Universal – Public Domain Dedication license
+ * Original Author: Vincent Reverdy (LAPP, France)
+ * Source: CppCon 2023 "Symbolic Calculus for High-performance Computing From Scratch Using C++23"
+ */
+
+/*
+ * lam.symbols:cache
+ * Description: Stateful evaluation recomputing only the subtrees whose inputs changed.
+ * Content: dependency_mask_v, cached_formula, cache.
+ * Extending Author: Colin Ford
+ */
+
+module;
+
+import std;
+
+export module lam.symbols:cache;
+import :traits;
+import :core;
+import :engine;
+
+export namespace lam::symbols
+{
+
+/*
+ *  Dependencies
+ *  dependency_mask_v<std::tuple<x, y, z>, Term> has bit i set when Term
+ *  contains the i-th symbol of the list.
+ */
+
+template<typename Symbols, typename Term>
+constexpr std::uint64_t dependency_mask_v = 0;
+template<typename... Symbols, typename Term>
+constexpr std::uint64_t dependency_mask_v<std::tuple<Symbols...>, Term> = [] {
+  std::uint64_t mask = 0;
+  std::uint64_t bit = 1;
+  ((mask |= contains_symbol_v<Term, Symbols> ? bit : 0, bit <<= 1), ...);
+  return mask;
+}();
+
+/*
+ *  Slots
+ *  A subtree depending on fewer symbols than its parent is cut out into a slot
+ *  of its own, and the parent reads it through a reserved symbol, like the
+ *  shared subtrees of formula_bundle. A subtree depending on the same symbols
+ *  as its parent always changes with it and stays inline, and so does one
+ *  addition or multiplication of leaves: recomputing it is cheaper than the
+ *  test, load and store of a slot. Slots are numbered operands first, so every
+ *  slot only reads slots before it.
+ */
+
+// Trait: one +, -, * or integer power of leaves
+template<typename T>
+struct is_cheap_node : std::false_type
+{};
+template<typename Op, typename... Terms>
+  requires(!is_symbolic_expression<Terms>::value && ...)
+struct is_cheap_node<symbolic_expression<Op, Terms...>>
+  : std::bool_constant<std::is_same_v<Op, std::plus<void>> || std::is_same_v<Op, std::minus<void>> ||
+                       std::is_same_v<Op, std::multiplies<void>> || std::is_same_v<Op, std::negate<void>>>
+{};
+template<typename Base, auto C>
+  requires(!is_symbolic_expression<Base>::value)
+struct is_cheap_node<symbolic_expression<power<void>, Base, constant_symbol<C>>>
+  : std::bool_constant<std::is_integral_v<decltype(C)>>
+{};
+
+template<std::size_t K>
+struct cached_subexpression_tag
+{};
+
+template<std::size_t K>
+using cached_subexpression_symbol = symbol<unconstrained, symbol_id<cached_subexpression_tag<K>>{}>;
+
+template<std::uint64_t Mask, typename Node>
+struct cache_slot
+{
+  static constexpr std::uint64_t mask = Mask;
+  Node node;
+};
+
+template<typename Symbols, std::size_t Offset, std::uint64_t ParentMask, typename Term>
+constexpr auto split_subtrees(const Term& term);
+
+// Splits the operands I... of a node in turn: (rewritten operands, their slots)
+template<typename Symbols, std::size_t Offset, std::uint64_t ParentMask, std::size_t I = 0, typename Tuple,
+         typename... Done, typename... Slots>
+constexpr auto split_operands(const Tuple& terms, std::tuple<Done...> done, std::tuple<Slots...> slots)
+{
+  if constexpr (I == std::tuple_size_v<Tuple>)
+    return std::pair{done, slots};
+  else
+  {
+    auto [operand, operand_slots] = split_subtrees<Symbols, Offset + sizeof...(Slots), ParentMask>(std::get<I>(terms));
+    return split_operands<Symbols, Offset, ParentMask, I + 1>(terms, std::tuple_cat(done, std::tuple{operand}),
+                                                              std::tuple_cat(slots, operand_slots));
+  }
+}
+
+// (rewritten term, slots of the term); the rewritten nodes must not be simplified again
+template<typename Symbols, std::size_t Offset, std::uint64_t ParentMask, typename Term>
+constexpr auto split_subtrees(const Term& term)
+{
+  if constexpr (is_symbolic_expression<Term>::value)
+  {
+    constexpr std::uint64_t mask = dependency_mask_v<Symbols, Term>;
+    auto [operands, slots] = split_operands<Symbols, Offset, mask>(term.terms, std::tuple<>{}, std::tuple<>{});
+    auto node = std::apply(
+      [](const auto&... operand) {
+        return symbolic_expression<expr_op_t<Term>, std::remove_cvref_t<decltype(operand)>...>(operand...);
+      },
+      operands);
+    if constexpr (mask != ParentMask && !is_cheap_node<Term>::value)
+    {
+      constexpr std::size_t slot = Offset + std::tuple_size_v<decltype(slots)>;
+      return std::pair{cached_subexpression_symbol<slot>{},
+                       std::tuple_cat(slots, std::tuple{cache_slot<mask, decltype(node)>{node}})};
+    }
+    else
+      return std::pair{node, slots};
+  }
+  else
+    return std::pair{term, std::tuple<>{}};
+}
+
+// Positional substitution over the symbols, then slots 0, ..., K - 1, every value by reference
+template<typename Symbols, typename Slots, typename... Values>
+struct cache_substitution;
+template<typename... Symbols, std::size_t... Ks, typename... Values>
+struct cache_substitution<std::tuple<Symbols...>, std::index_sequence<Ks...>, Values...>
+{
+  using type = positional_substitution<std::tuple<Symbols..., cached_subexpression_symbol<Ks>...>, const Values&...>;
+};
+
+// Value type of every slot, each one evaluated against the inputs and the slots before it
+template<typename Symbols, typename T, typename Slots, typename Values = std::tuple<>>
+struct cache_value_types;
+template<typename... Symbols, typename T, typename... Slots, typename... Values>
+struct cache_value_types<std::tuple<Symbols...>, T, std::tuple<Slots...>, std::tuple<Values...>>
+{
+  static constexpr std::size_t K = sizeof...(Values);
+  using substitution_type = typename cache_substitution<std::tuple<Symbols...>, std::make_index_sequence<K>,
+                                                        decltype((void)std::type_identity<Symbols>{}, T{})...,
+                                                        Values...>::type;
+  using node_type = decltype(std::declval<const std::tuple_element_t<K, std::tuple<Slots...>>&>().node);
+  using value_type = std::remove_cvref_t<decltype(std::declval<const node_type&>()(std::declval<const substitution_type&>()))>;
+  using type = typename cache_value_types<std::tuple<Symbols...>, T, std::tuple<Slots...>,
+                                          std::tuple<Values..., value_type>>::type;
+};
+template<typename... Symbols, typename T, typename... Slots, typename... Values>
+  requires(sizeof...(Values) == sizeof...(Slots))
+struct cache_value_types<std::tuple<Symbols...>, T, std::tuple<Slots...>, std::tuple<Values...>>
+{ using type = std::tuple<Values...>; };
+
+/*
+ *  cached_formula
+ *  f = cache(expr, x, y, gm, m) is called positionally, f(1.0, 2.0, 3.0, 4.0),
+ *  like compile(expr, x, y, gm, m), but keeps the inputs and the value of every
+ *  slot from the previous call: a slot is recomputed only when one of the
+ *  symbols it depends on changed (compared with !=, so a NaN input always
+ *  counts as changed). The first call, and the first after reset(), computes
+ *  everything. Every input is converted to T. Not thread safe: one cached
+ *  formula per thread.
+ */
+
+template<symbolic Expression, typename T, typename... Symbols>
+  requires(is_symbol_v<Symbols> && ...)
+struct cached_formula
+{
+  static_assert(are_distinct_types_v<Symbols...>, "cache: each symbol may only appear once");
+  static_assert(sizeof...(Symbols) <= 64, "cache: at most 64 symbols");
+
+  using expression_type = Expression;
+  using symbols_type = std::tuple<Symbols...>;
+  static constexpr std::size_t arity = sizeof...(Symbols);
+
+  using plan_type = decltype(split_subtrees<symbols_type, 0, ~std::uint64_t{0}>(std::declval<const Expression&>()));
+  using root_type = typename plan_type::first_type;
+  using slots_type = typename plan_type::second_type;
+  using values_type = typename cache_value_types<symbols_type, T, slots_type>::type;
+  static constexpr std::size_t slot_count = std::tuple_size_v<slots_type>;
+
+  root_type root;
+  slots_type slots;
+  values_type values{};
+  std::array<T, arity> last{};
+  bool primed = false;
+
+  constexpr cached_formula(const Expression& expr)
+    : cached_formula(split_subtrees<symbols_type, 0, ~std::uint64_t{0}>(expr))
+  {}
+
+  constexpr cached_formula(plan_type plan) : root(plan.first), slots(plan.second) {}
+
+  // Positional call: f(x_val, y_val, ...), recomputing the slots whose inputs changed
+  template<typename... Inputs>
+    requires(sizeof...(Inputs) == arity && (std::is_convertible_v<Inputs, T> && ...))
+  constexpr auto operator()(Inputs... inputs)
+  {
+    const std::uint64_t changed = compare_and_store(std::make_index_sequence<arity>{}, static_cast<T>(inputs)...);
+    const auto s = substitution(std::make_index_sequence<arity>{}, std::make_index_sequence<slot_count>{});
+    if (changed != 0 || !primed)
+      update(s, changed, !primed, std::make_index_sequence<slot_count>{});
+    primed = true;
+    return evaluate_term(root, s);
+  }
+
+  // Forgets every value: the next call computes everything
+  constexpr void reset() noexcept { primed = false; }
+
+  // Bit i set when input i differs from last time. Only changed inputs are stored:
+  // copying them all lets the compiler merge the loads of the caller's values into
+  // vector loads, which stall on the caller's latest scalar stores
+  template<std::size_t... Is>
+  constexpr std::uint64_t compare_and_store(std::index_sequence<Is...>, decltype((void)Is, T{})... current)
+  {
+    std::uint64_t changed = 0;
+    ((current != last[Is] ? void((changed |= std::uint64_t{1} << Is, last[Is] = current)) : void()), ...);
+    return changed;
+  }
+
+  template<std::size_t... Is, std::size_t... Ks>
+  constexpr auto substitution(std::index_sequence<Is...>, std::index_sequence<Ks...>) const
+  {
+    return typename cache_substitution<symbols_type, std::index_sequence<Ks...>,
+                                       decltype((void)Is, T{})...,
+                                       std::tuple_element_t<Ks, values_type>...>::type(last[Is]..., std::get<Ks>(values)...);
+  }
+
+  // Slots in order: each one reads the slots before it, already up to date
+  template<typename Substitution, std::size_t... Ks>
+  constexpr void update(const Substitution& s, std::uint64_t changed, bool everything, std::index_sequence<Ks...>)
+  {
+    ((everything || (std::tuple_element_t<Ks, slots_type>::mask & changed)
+        ? void(std::get<Ks>(values) = std::get<Ks>(slots).node(s))
+        : void()),
+     ...);
+  }
+};
+
+template<typename T = double, symbolic Expression, typename... Symbols>
+  requires(is_symbol_v<Symbols> && ...)
+constexpr auto cache(const Expression& expr, const Symbols&...)
+{
+  return cached_formula<Expression, T, std::remove_cvref_t<Symbols>...>(expr);
+}
+
+template<typename T = double, symbolic Expression, typename... Symbols>
+  requires(is_symbol_v<Symbols> && ...)
+constexpr auto cache(const formula<Expression>& f, const Symbols&... symbols)
+{
+  return cache<T>(f.expression, symbols...);
+}
+
+} // end namespace lam::symbols
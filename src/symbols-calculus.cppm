@@ -0,0 +1,1197 @@
+/*
+ * Provided under CC0 1.0 Universal – Public Domain Dedication license
+ * Original Author: Vincent Reverdy (LAPP, France)
+ * Source: CppCon 2023 "Symbolic Calculus for High-performance Computing From Scratch Using C++23"
+ */
+
+/*
+ * lam.symbols:calculus
+ * Description: Symbolic calculus on expression types, resolved at compile time.
+ * Content: natural_log, unary_derivative, derivative, jacobian, jacobian_sparsity, hessian,
+ *          gradient (reverse mode), taylor, integrate.
+ * Note: differentiate before running a pass; rewritten nodes have no derivative rules.
+ * Extending Author: Colin Ford
+ */
+
+module;
+
+import std;
+
+export module lam.symbols:calculus;
+import :traits;
+import :core;
+import :engine;
+import :bundle;
+
+export namespace lam::symbols
+{
+
+/*
+ *  Elementary Operators
+ *  natural_log is the logarithm of the general power rule, found by argument
+ *  dependent lookup like pow, std::log for builtin types.
+ */
+
+struct natural_log
+{
+  template<typename T>
+  constexpr auto operator()(const T& x) const
+  {
+    using std::log;
+    return log(x);
+  }
+};
+
+template<typename Arg>
+constexpr auto simplify_log(Arg&& arg)
+{
+  if constexpr (is_structural_one_v<Arg>)
+    return constant_symbol<0>{};
+  else
+    return simplify_expression(natural_log{}, std::forward<Arg>(arg));
+}
+
+/*
+ *  Unary Derivatives
+ *  unary_derivative<Op>{}(u) is the derivative of Op at u, the chain rule
+ *  multiplying it by du. Specialize it to make a custom unary operator
+ *  differentiable:
+ *    template<> struct unary_derivative<SinOp>
+ *    { constexpr auto operator()(const auto& u) const { return cos(u); } };
+ */
+
+template<typename Operator>
+struct unary_derivative
+{};
+
+template<>
+struct unary_derivative<natural_log>
+{
+  template<typename Arg>
+  constexpr auto operator()(const Arg& u) const
+  { return simplify_div(constant_symbol<1>{}, u); }
+};
+
+template<typename Operator, typename Arg>
+constexpr bool has_unary_derivative_v = std::is_invocable_v<const unary_derivative<Operator>&, const Arg&>;
+
+/*
+ *  Derivative
+ *  derivative(expr, x) builds d expr / dx as a new expression type, each rule
+ *  going through simplify_*, so zero and unit factors vanish as the tree is
+ *  built: derivative(x^3 + 2 * x * y, x) is 3 * x^2 + 2 * y. A subtree free of
+ *  x is a structural zero without being visited.
+ */
+
+template<typename Symbol, typename Term>
+constexpr auto derivative_of(const Term& term);
+
+// Left fold of simplify_add
+template<typename First, typename... Rest>
+constexpr auto simplify_sum(const First& first, const Rest&... rest)
+{
+  if constexpr (sizeof...(Rest) == 0)
+    return first;
+  else
+    return [&](const auto& next, const auto&... others) {
+      return simplify_sum(simplify_add(first, next), others...);
+    }(rest...);
+}
+
+// Left fold of simplify_mul
+template<typename First, typename... Rest>
+constexpr auto simplify_product(const First& first, const Rest&... rest)
+{
+  if constexpr (sizeof...(Rest) == 0)
+    return first;
+  else
+    return [&](const auto& next, const auto&... others) {
+      return simplify_product(simplify_mul(first, next), others...);
+    }(rest...);
+}
+
+// t0 * ... * dti * ... * tn
+template<typename Symbol, std::size_t I, typename... Terms, std::size_t... Js>
+constexpr auto differentiate_factor(const std::tuple<Terms...>& terms, std::index_sequence<Js...>)
+{
+  if constexpr (!contains_symbol_v<std::tuple_element_t<I, std::tuple<Terms...>>, Symbol>)
+    return constant_symbol<0>{};
+  else
+    return simplify_product([&]() {
+      if constexpr (Js == I)
+        return derivative_of<Symbol>(std::get<Js>(terms));
+      else
+        return std::get<Js>(terms);
+    }()...);
+}
+
+// u^e: e * u^(e - 1) * du for e free of the symbol, u^e * (de * log(u) + e * du / u) otherwise
+template<typename Symbol, typename Base, typename Exp>
+constexpr auto differentiate_power(const Base& u, const Exp& e)
+{
+  if constexpr (!contains_symbol_v<Exp, Symbol>)
+  {
+    const auto reduced = [&] {
+      if constexpr (is_constant_symbol_v<Exp>)
+        return simplify_pow(u, fold_constants(std::minus<void>{}, e, constant_symbol<1>{}));
+      else
+        return simplify_pow(u, simplify_sub(e, constant_symbol<1>{}));
+    }();
+    return simplify_product(e, reduced, derivative_of<Symbol>(u));
+  }
+  else if constexpr (!contains_symbol_v<Base, Symbol>)
+    return simplify_product(simplify_pow(u, e), simplify_log(u), derivative_of<Symbol>(e));
+  else
+    return simplify_mul(simplify_pow(u, e),
+                        simplify_add(simplify_mul(derivative_of<Symbol>(e), simplify_log(u)),
+                                     simplify_div(simplify_mul(e, derivative_of<Symbol>(u)), u)));
+}
+
+// u / v: du / v for v free of the symbol, (du * v - u * dv) / v^2 otherwise
+template<typename Symbol, typename Numerator, typename Denominator>
+constexpr auto differentiate_quotient(const Numerator& u, const Denominator& v)
+{
+  if constexpr (!contains_symbol_v<Denominator, Symbol>)
+    return simplify_div(derivative_of<Symbol>(u), v);
+  else
+    return simplify_div(
+      simplify_sub(simplify_mul(derivative_of<Symbol>(u), v), simplify_mul(u, derivative_of<Symbol>(v))),
+      simplify_pow(v, constant_symbol<2>{}));
+}
+
+template<typename Symbol, typename Term>
+constexpr auto derivative_of(const Term& term)
+{
+  if constexpr (!contains_symbol_v<Term, Symbol>)
+    return constant_symbol<0>{};
+  else if constexpr (!is_symbolic_expression<Term>::value)
+    // the symbol itself
+    return constant_symbol<1>{};
+  else
+  {
+    using op = expr_op_t<Term>;
+    constexpr std::size_t arity = std::tuple_size_v<decltype(term.terms)>;
+    if constexpr (std::is_same_v<op, std::plus<void>>)
+      return std::apply([](const auto&... operand) { return simplify_sum(derivative_of<Symbol>(operand)...); },
+                        term.terms);
+    else if constexpr (std::is_same_v<op, std::minus<void>>)
+      return std::apply(
+        [](const auto& first, const auto&... rest) {
+          return simplify_sub(derivative_of<Symbol>(first), simplify_sum(derivative_of<Symbol>(rest)...));
+        },
+        term.terms);
+    else if constexpr (std::is_same_v<op, std::multiplies<void>>)
+      return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        return simplify_sum(differentiate_factor<Symbol, Is>(term.terms, std::make_index_sequence<arity>{})...);
+      }(std::make_index_sequence<arity>{});
+    else if constexpr (std::is_same_v<op, std::divides<void>> && arity == 2)
+      return differentiate_quotient<Symbol>(std::get<0>(term.terms), std::get<1>(term.terms));
+    else if constexpr (std::is_same_v<op, power<void>> && arity == 2)
+      return differentiate_power<Symbol>(std::get<0>(term.terms), std::get<1>(term.terms));
+    else if constexpr (std::is_same_v<op, std::negate<void>>)
+      return simplify_neg(derivative_of<Symbol>(std::get<0>(term.terms)));
+    else if constexpr (arity == 1 && has_unary_derivative_v<op, std::tuple_element_t<0, decltype(term.terms)>>)
+      return simplify_mul(unary_derivative<op>{}(std::get<0>(term.terms)),
+                          derivative_of<Symbol>(std::get<0>(term.terms)));
+    else
+      static_assert(sizeof(Term) == 0,
+                    "derivative: no rule for this operator, specialize unary_derivative for a unary one");
+  }
+}
+
+template<symbolic Expression, typename Symbol>
+  requires is_symbol_v<Symbol>
+constexpr auto derivative(const Expression& expr, const Symbol&)
+{ return derivative_of<std::remove_cvref_t<Symbol>>(expr); }
+
+template<symbolic Expression, typename Symbol>
+  requires is_symbol_v<Symbol>
+constexpr auto derivative(const formula<Expression>& f, const Symbol& symbol)
+{ return formula{derivative(f.expression, symbol)}; }
+
+/*
+ *  Jacobian
+ *  jacobian(std::tuple{f, g}, x, y) differentiates every output with respect
+ *  to every symbol at compile time. Structurally zero partials are dropped and
+ *  the others form one formula_bundle: a partial equal to another, or a
+ *  subtree shared between partials, is evaluated once per call. dense() writes
+ *  the rows x columns matrix row major; sparse() writes the nonzero partials
+ *  only, the k-th at (row_indices[k], column_indices[k]), row major.
+ */
+
+template<typename Output, typename Symbol>
+using partial_t = std::remove_cvref_t<decltype(derivative_of<Symbol>(std::declval<const Output&>()))>;
+
+template<typename Symbols, symbolic... Outputs>
+struct jacobian_formula;
+template<typename... Symbols, symbolic... Outputs>
+struct jacobian_formula<std::tuple<Symbols...>, Outputs...>
+{
+  static_assert(are_distinct_types_v<Symbols...>, "jacobian: each symbol may only appear once");
+
+  using symbols_type = std::tuple<Symbols...>;
+  using outputs_type = std::tuple<Outputs...>;
+  static constexpr std::size_t rows = sizeof...(Outputs);
+  static constexpr std::size_t columns = sizeof...(Symbols);
+
+  // Partial of output K / columns with respect to symbol K % columns
+  template<std::size_t K>
+  using entry_t =
+    partial_t<std::tuple_element_t<K / columns, outputs_type>, std::tuple_element_t<K % columns, symbols_type>>;
+
+  static constexpr std::array<bool, rows * columns> structural_zeros = [] {
+    std::array<bool, rows * columns> zeros{};
+    [&]<std::size_t... Ks>(std::index_sequence<Ks...>) {
+      ((zeros[Ks] = is_structural_zero_v<entry_t<Ks>>), ...);
+    }(std::make_index_sequence<rows * columns>{});
+    return zeros;
+  }();
+  static constexpr std::size_t nonzeros = static_cast<std::size_t>(std::ranges::count(structural_zeros, false));
+  static_assert(nonzeros > 0, "jacobian: every partial is structurally zero");
+
+  // Row major positions of the nonzero partials, then of the zeros
+  template<bool Zero, std::size_t N>
+  static constexpr std::array<std::size_t, N> positions = [] {
+    std::array<std::size_t, N> found{};
+    std::size_t n = 0;
+    for (std::size_t k = 0; k < rows * columns; ++k)
+      if (structural_zeros[k] == Zero)
+        found[n++] = k;
+    return found;
+  }();
+  static constexpr auto nonzero_positions = positions<false, nonzeros>;
+  static constexpr auto zero_positions = positions<true, rows * columns - nonzeros>;
+
+  static constexpr auto row_indices = [] {
+    std::array<std::size_t, nonzeros> indices{};
+    for (std::size_t n = 0; n < nonzeros; ++n)
+      indices[n] = nonzero_positions[n] / columns;
+    return indices;
+  }();
+  static constexpr auto column_indices = [] {
+    std::array<std::size_t, nonzeros> indices{};
+    for (std::size_t n = 0; n < nonzeros; ++n)
+      indices[n] = nonzero_positions[n] % columns;
+    return indices;
+  }();
+
+  using bundle_type = typename decltype([]<std::size_t... Ns>(std::index_sequence<Ns...>) {
+    return std::type_identity<formula_bundle<entry_t<nonzero_positions[Ns]>...>>{};
+  }(std::make_index_sequence<nonzeros>{}))::type;
+
+  bundle_type bundle;
+
+  constexpr jacobian_formula(const outputs_type& outputs)
+    : bundle([&]<std::size_t... Ns>(std::index_sequence<Ns...>) {
+        return bundle_type(derivative_of<std::tuple_element_t<nonzero_positions[Ns] % columns, symbols_type>>(
+          std::get<nonzero_positions[Ns] / columns>(outputs))...);
+      }(std::make_index_sequence<nonzeros>{}))
+  {}
+
+  // Binder call: out holds at least rows * columns elements
+  template<typename T, std::size_t Extent, class... Args>
+    requires(Extent == std::dynamic_extent || Extent >= rows * columns)
+  constexpr void dense(std::span<T, Extent> out, Args... args) const
+  { write_dense(out, bundle(args...)); }
+
+  // Binder call: out holds at least nonzeros elements
+  template<typename T, std::size_t Extent, class... Args>
+    requires(Extent == std::dynamic_extent || Extent >= nonzeros)
+  constexpr void sparse(std::span<T, Extent> out, Args... args) const
+  { write_sparse(out, bundle(args...)); }
+
+  // values: the tuple of nonzero partials evaluated by the bundle
+  template<typename T, std::size_t Extent, typename Values>
+  static constexpr void write_dense(std::span<T, Extent> out, const Values& values)
+  {
+    [&]<std::size_t... Ns, std::size_t... Zs>(std::index_sequence<Ns...>, std::index_sequence<Zs...>) {
+      ((out[nonzero_positions[Ns]] = static_cast<T>(std::get<Ns>(values))), ...);
+      ((out[zero_positions[Zs]] = T{0}), ...);
+    }(std::make_index_sequence<nonzeros>{}, std::make_index_sequence<rows * columns - nonzeros>{});
+  }
+
+  template<typename T, std::size_t Extent, typename Values>
+  static constexpr void write_sparse(std::span<T, Extent> out, const Values& values)
+  {
+    [&]<std::size_t... Ns>(std::index_sequence<Ns...>) {
+      ((out[Ns] = static_cast<T>(std::get<Ns>(values))), ...);
+    }(std::make_index_sequence<nonzeros>{});
+  }
+};
+
+template<symbolic... Outputs, typename... Symbols>
+  requires(is_symbol_v<Symbols> && ...)
+constexpr auto jacobian(const std::tuple<Outputs...>& outputs, const Symbols&...)
+{ return jacobian_formula<std::tuple<std::remove_cvref_t<Symbols>...>, Outputs...>(outputs); }
+
+template<symbolic... Outputs, typename... Symbols>
+  requires(is_symbol_v<Symbols> && ...)
+constexpr auto jacobian(const formula_bundle<Outputs...>& bundle, const Symbols&... symbols)
+{ return jacobian(expand_shared(bundle), symbols...); }
+
+// Positional kernel of a Jacobian, the symbols in compile order (wrt symbols and parameters alike)
+template<typename Jacobian, typename Kernel>
+struct compiled_jacobian
+{
+  static constexpr std::size_t rows = Jacobian::rows;
+  static constexpr std::size_t columns = Jacobian::columns;
+  static constexpr std::size_t nonzeros = Jacobian::nonzeros;
+  static constexpr auto row_indices = Jacobian::row_indices;
+  static constexpr auto column_indices = Jacobian::column_indices;
+
+  Kernel kernel;
+
+  template<typename T, std::size_t Extent, typename... Values>
+    requires(sizeof...(Values) == Kernel::arity && (Extent == std::dynamic_extent || Extent >= rows * columns))
+  constexpr void dense(std::span<T, Extent> out, Values... values) const
+  { Jacobian::write_dense(out, kernel(values...)); }
+
+  template<typename T, std::size_t Extent, typename... Values>
+    requires(sizeof...(Values) == Kernel::arity && (Extent == std::dynamic_extent || Extent >= nonzeros))
+  constexpr void sparse(std::span<T, Extent> out, Values... values) const
+  { Jacobian::write_sparse(out, kernel(values...)); }
+};
+
+template<typename WithRespectTo, symbolic... Outputs, typename... Symbols>
+  requires(is_symbol_v<Symbols> && ...)
+constexpr auto compile(const jacobian_formula<WithRespectTo, Outputs...>& j, const Symbols&... symbols) noexcept
+{
+  auto kernel = compile(j.bundle, symbols...);
+  return compiled_jacobian<jacobian_formula<WithRespectTo, Outputs...>, decltype(kernel)>{kernel};
+}
+
+/*
+ *  Sparsity
+ *  jacobian_sparsity<std::tuple<Symbols...>, Outputs...> is the structure of
+ *  d output_i / d symbol_j read from the expression types alone: entry (i, j)
+ *  may be nonzero when output i contains symbol j. No derivative is built.
+ *  bitmap holds it row major; row_offsets / column_indices (CSR) and
+ *  column_offsets / row_indices (CSC) index the nonzeros, row major and
+ *  column major. colors partitions the columns so that no two columns of a
+ *  color share a row: seeding every symbol of a color at once, forward mode
+ *  or finite differences recover the Jacobian in color_count evaluations
+ *  instead of one per symbol. The coloring is greedy, in column order.
+ */
+
+template<typename Symbols, symbolic... Outputs>
+struct jacobian_sparsity;
+template<typename... Symbols, symbolic... Outputs>
+struct jacobian_sparsity<std::tuple<Symbols...>, Outputs...>
+{
+  static_assert(are_distinct_types_v<Symbols...>, "jacobian_sparsity: each symbol may only appear once");
+
+  static constexpr std::size_t rows = sizeof...(Outputs);
+  static constexpr std::size_t columns = sizeof...(Symbols);
+
+  static constexpr std::array<bool, rows * columns> bitmap = [] {
+    std::array<bool, rows * columns> pattern{};
+    std::size_t k = 0;
+    (
+      [&]<typename Output>(std::type_identity<Output>) {
+        ((pattern[k++] = contains_symbol_v<Output, Symbols>), ...);
+      }(std::type_identity<Outputs>{}),
+      ...);
+    return pattern;
+  }();
+  static constexpr std::size_t nonzeros = static_cast<std::size_t>(std::ranges::count(bitmap, true));
+
+  static constexpr bool structural(std::size_t i, std::size_t j) { return bitmap[i * columns + j]; }
+
+  // Compressed sparse rows
+  static constexpr std::array<std::size_t, rows + 1> row_offsets = [] {
+    std::array<std::size_t, rows + 1> offsets{};
+    for (std::size_t i = 0; i < rows; ++i)
+      offsets[i + 1] = offsets[i] + static_cast<std::size_t>(std::count(
+                                      bitmap.begin() + i * columns, bitmap.begin() + (i + 1) * columns, true));
+    return offsets;
+  }();
+  static constexpr std::array<std::size_t, nonzeros> column_indices = [] {
+    std::array<std::size_t, nonzeros> indices{};
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < rows; ++i)
+      for (std::size_t j = 0; j < columns; ++j)
+        if (structural(i, j))
+          indices[n++] = j;
+    return indices;
+  }();
+
+  // Compressed sparse columns
+  static constexpr std::array<std::size_t, columns + 1> column_offsets = [] {
+    std::array<std::size_t, columns + 1> offsets{};
+    for (std::size_t j = 0; j < columns; ++j)
+    {
+      offsets[j + 1] = offsets[j];
+      for (std::size_t i = 0; i < rows; ++i)
+        offsets[j + 1] += structural(i, j) ? 1 : 0;
+    }
+    return offsets;
+  }();
+  static constexpr std::array<std::size_t, nonzeros> row_indices = [] {
+    std::array<std::size_t, nonzeros> indices{};
+    std::size_t n = 0;
+    for (std::size_t j = 0; j < columns; ++j)
+      for (std::size_t i = 0; i < rows; ++i)
+        if (structural(i, j))
+          indices[n++] = i;
+    return indices;
+  }();
+
+  // Greedy distance-1 coloring of the column intersection graph
+  static constexpr std::array<std::size_t, columns> colors = [] {
+    std::array<std::size_t, columns> color{};
+    for (std::size_t j = 0; j < columns; ++j)
+    {
+      std::array<bool, columns + 1> taken{};
+      for (std::size_t other = 0; other < j; ++other)
+        for (std::size_t i = 0; i < rows; ++i)
+          if (structural(i, j) && structural(i, other))
+            taken[color[other]] = true;
+      while (taken[color[j]])
+        ++color[j];
+    }
+    return color;
+  }();
+  static constexpr std::size_t color_count = columns == 0 ? 0 : std::ranges::max(colors) + 1;
+};
+
+template<symbolic... Outputs, typename... Symbols>
+  requires(is_symbol_v<Symbols> && ...)
+constexpr auto sparsity_pattern(const std::tuple<Outputs...>&, const Symbols&...)
+{ return jacobian_sparsity<std::tuple<std::remove_cvref_t<Symbols>...>, Outputs...>{}; }
+
+template<symbolic... Outputs, typename... Symbols>
+  requires(is_symbol_v<Symbols> && ...)
+constexpr auto sparsity_pattern(const formula_bundle<Outputs...>&, const Symbols&...)
+{ return jacobian_sparsity<std::tuple<std::remove_cvref_t<Symbols>...>, Outputs...>{}; }
+
+/*
+ *  Hessian
+ *  hessian(expr, x, y, z) differentiates expr twice at compile time, the upper
+ *  triangle only. Row i differentiates the first derivative along symbol i,
+ *  built once, rather than expr again. The nonzero entries form one
+ *  formula_bundle, so subtrees shared between rows are evaluated once per
+ *  call. packed() writes the triangle as LAPACK's upper packed storage,
+ *  H(i, j), i <= j, at i + j (j + 1) / 2; dense() writes the full symmetric
+ *  matrix row major.
+ */
+
+template<typename Symbols, symbolic Expression>
+struct hessian_formula;
+template<typename... Symbols, symbolic Expression>
+struct hessian_formula<std::tuple<Symbols...>, Expression>
+{
+  static_assert(are_distinct_types_v<Symbols...>, "hessian: each symbol may only appear once");
+
+  using symbols_type = std::tuple<Symbols...>;
+  static constexpr std::size_t order = sizeof...(Symbols);
+  static constexpr std::size_t packed_size = order * (order + 1) / 2;
+
+  static constexpr std::size_t packed_index(std::size_t i, std::size_t j) noexcept
+  { return i <= j ? i + j * (j + 1) / 2 : j + i * (i + 1) / 2; }
+
+  // Row and column of packed entry K
+  static constexpr auto packed_rows = [] {
+    std::array<std::size_t, packed_size> rows{};
+    for (std::size_t j = 0; j < order; ++j)
+      for (std::size_t i = 0; i <= j; ++i)
+        rows[packed_index(i, j)] = i;
+    return rows;
+  }();
+  static constexpr auto packed_columns = [] {
+    std::array<std::size_t, packed_size> columns{};
+    for (std::size_t j = 0; j < order; ++j)
+      for (std::size_t i = 0; i <= j; ++i)
+        columns[packed_index(i, j)] = j;
+    return columns;
+  }();
+
+  template<std::size_t I>
+  using first_t = partial_t<Expression, std::tuple_element_t<I, symbols_type>>;
+  // Packed entry K: the first derivative along its row, differentiated along its column
+  template<std::size_t K>
+  using entry_t = partial_t<first_t<packed_rows[K]>, std::tuple_element_t<packed_columns[K], symbols_type>>;
+
+  static constexpr std::array<bool, packed_size> structural_zeros = [] {
+    std::array<bool, packed_size> zeros{};
+    [&]<std::size_t... Ks>(std::index_sequence<Ks...>) {
+      ((zeros[Ks] = is_structural_zero_v<entry_t<Ks>>), ...);
+    }(std::make_index_sequence<packed_size>{});
+    return zeros;
+  }();
+  static constexpr std::size_t nonzeros = static_cast<std::size_t>(std::ranges::count(structural_zeros, false));
+  static_assert(nonzeros > 0, "hessian: every second partial is structurally zero");
+
+  // Packed positions of the nonzero entries, then of the zeros
+  template<bool Zero, std::size_t N>
+  static constexpr std::array<std::size_t, N> positions = [] {
+    std::array<std::size_t, N> found{};
+    std::size_t n = 0;
+    for (std::size_t k = 0; k < packed_size; ++k)
+      if (structural_zeros[k] == Zero)
+        found[n++] = k;
+    return found;
+  }();
+  static constexpr auto nonzero_positions = positions<false, nonzeros>;
+  static constexpr auto zero_positions = positions<true, packed_size - nonzeros>;
+
+  using bundle_type = typename decltype([]<std::size_t... Ns>(std::index_sequence<Ns...>) {
+    return std::type_identity<formula_bundle<entry_t<nonzero_positions[Ns]>...>>{};
+  }(std::make_index_sequence<nonzeros>{}))::type;
+
+  bundle_type bundle;
+
+  constexpr hessian_formula(const Expression& expr)
+    : bundle([&] {
+        // every first derivative once, then the nonzero entries from them
+        const auto first = std::make_tuple(derivative_of<Symbols>(expr)...);
+        return [&]<std::size_t... Ns>(std::index_sequence<Ns...>) {
+          return bundle_type(derivative_of<std::tuple_element_t<packed_columns[nonzero_positions[Ns]], symbols_type>>(
+            std::get<packed_rows[nonzero_positions[Ns]]>(first))...);
+        }(std::make_index_sequence<nonzeros>{});
+      }())
+  {}
+
+  // Binder call: out holds at least packed_size elements
+  template<typename T, std::size_t Extent, class... Args>
+    requires(Extent == std::dynamic_extent || Extent >= packed_size)
+  constexpr void packed(std::span<T, Extent> out, Args... args) const
+  { write_packed(out, bundle(args...)); }
+
+  // Binder call: out holds at least order * order elements
+  template<typename T, std::size_t Extent, class... Args>
+    requires(Extent == std::dynamic_extent || Extent >= order * order)
+  constexpr void dense(std::span<T, Extent> out, Args... args) const
+  { write_dense(out, bundle(args...)); }
+
+  // values: the tuple of nonzero entries evaluated by the bundle
+  template<typename T, std::size_t Extent, typename Values>
+  static constexpr void write_packed(std::span<T, Extent> out, const Values& values)
+  {
+    [&]<std::size_t... Ns, std::size_t... Zs>(std::index_sequence<Ns...>, std::index_sequence<Zs...>) {
+      ((out[nonzero_positions[Ns]] = static_cast<T>(std::get<Ns>(values))), ...);
+      ((out[zero_positions[Zs]] = T{0}), ...);
+    }(std::make_index_sequence<nonzeros>{}, std::make_index_sequence<packed_size - nonzeros>{});
+  }
+
+  template<typename T, std::size_t Extent, typename Values>
+  static constexpr void write_dense(std::span<T, Extent> out, const Values& values)
+  {
+    [&]<std::size_t... Ns, std::size_t... Zs>(std::index_sequence<Ns...>, std::index_sequence<Zs...>) {
+      constexpr auto at = [](std::size_t k, bool lower) {
+        return lower ? packed_columns[k] * order + packed_rows[k] : packed_rows[k] * order + packed_columns[k];
+      };
+      ((out[at(nonzero_positions[Ns], false)] = static_cast<T>(std::get<Ns>(values)),
+        out[at(nonzero_positions[Ns], true)] = static_cast<T>(std::get<Ns>(values))),
+       ...);
+      ((out[at(zero_positions[Zs], false)] = T{0}, out[at(zero_positions[Zs], true)] = T{0}), ...);
+    }(std::make_index_sequence<nonzeros>{}, std::make_index_sequence<packed_size - nonzeros>{});
+  }
+};
+
+template<symbolic Expression, typename... Symbols>
+  requires(is_symbol_v<Symbols> && ...)
+constexpr auto hessian(const Expression& expr, const Symbols&...)
+{ return hessian_formula<std::tuple<std::remove_cvref_t<Symbols>...>, Expression>(expr); }
+
+template<symbolic Expression, typename... Symbols>
+  requires(is_symbol_v<Symbols> && ...)
+constexpr auto hessian(const formula<Expression>& f, const Symbols&... symbols)
+{ return hessian(f.expression, symbols...); }
+
+// Positional kernel of a Hessian, the symbols in compile order (wrt symbols and parameters alike)
+template<typename Hessian, typename Kernel>
+struct compiled_hessian
+{
+  static constexpr std::size_t order = Hessian::order;
+  static constexpr std::size_t packed_size = Hessian::packed_size;
+  static constexpr std::size_t nonzeros = Hessian::nonzeros;
+
+  Kernel kernel;
+
+  static constexpr std::size_t packed_index(std::size_t i, std::size_t j) noexcept
+  { return Hessian::packed_index(i, j); }
+
+  template<typename T, std::size_t Extent, typename... Values>
+    requires(sizeof...(Values) == Kernel::arity && (Extent == std::dynamic_extent || Extent >= packed_size))
+  constexpr void packed(std::span<T, Extent> out, Values... values) const
+  { Hessian::write_packed(out, kernel(values...)); }
+
+  template<typename T, std::size_t Extent, typename... Values>
+    requires(sizeof...(Values) == Kernel::arity && (Extent == std::dynamic_extent || Extent >= order * order))
+  constexpr void dense(std::span<T, Extent> out, Values... values) const
+  { Hessian::write_dense(out, kernel(values...)); }
+};
+
+template<typename WithRespectTo, symbolic Expression, typename... Symbols>
+  requires(is_symbol_v<Symbols> && ...)
+constexpr auto compile(const hessian_formula<WithRespectTo, Expression>& h, const Symbols&... symbols) noexcept
+{
+  auto kernel = compile(h.bundle, symbols...);
+  return compiled_hessian<hessian_formula<WithRespectTo, Expression>, decltype(kernel)>{kernel};
+}
+
+/*
+ *  Reverse Mode
+ *  gradient(expr, x, y, ...) evaluates expr and its whole gradient in two
+ *  sweeps. The forward sweep keeps the value of every node in a tape shaped
+ *  like the tree; the reverse sweep pushes the adjoint of every node to its
+ *  operands, scaled by the local partials read from the tape. The cost is a
+ *  small multiple of one evaluation whatever the number of symbols, where
+ *  jacobian() builds one expression per symbol. Flattened sums and products
+ *  keep their N operands: the adjoints of a product's operands come from
+ *  prefix and suffix products, without division. Every symbol of expr must be
+ *  listed, every value is converted to T, and subtrees free of the symbols are
+ *  never swept.
+ */
+
+template<typename T, typename... Children>
+struct tape_node
+{
+  T value;
+  std::tuple<Children...> children;
+};
+
+template<typename T, std::size_t N>
+struct gradient_result
+{
+  T value;
+  std::array<T, N> gradient;
+};
+
+template<typename Term, typename Symbols>
+constexpr bool contains_any_symbol_v = false;
+template<typename Term, typename... Symbols>
+constexpr bool contains_any_symbol_v<Term, type_list<Symbols...>> = (contains_symbol_v<Term, Symbols> || ...);
+
+// Value of a node from the values of its operands
+template<typename Term, typename T, typename... Values>
+constexpr T node_value(const Values&... v)
+{
+  using op = expr_op_t<Term>;
+  if constexpr (has_constant_exponent<Term>::value)
+    return static_cast<T>(pow_by_constant<expr_rhs_t<Term>::value>(std::get<0>(std::tie(v...))));
+  else if constexpr (std::is_same_v<op, std::plus<void>>)
+    return (... + v);
+  else if constexpr (std::is_same_v<op, std::minus<void>>)
+    return (... - v);
+  else if constexpr (std::is_same_v<op, std::multiplies<void>>)
+    return (... * v);
+  else if constexpr (std::is_same_v<op, std::divides<void>>)
+    return (... / v);
+  else if constexpr (std::is_same_v<op, power<void>>)
+    return static_cast<T>(numeric_detail::pow_fn{}(v...));
+  else if constexpr (std::is_same_v<op, std::negate<void>>)
+    return -(v, ...);
+  else
+    return static_cast<T>(op{}(v...));
+}
+
+// Forward sweep: the tape of term, inputs in the order of Symbols
+template<typename T, typename Symbols, typename Term, std::size_t N>
+constexpr auto record(const Term& term, const std::array<T, N>& inputs)
+{
+  if constexpr (is_symbolic_expression<Term>::value)
+    return std::apply(
+      [&](const auto&... operand) {
+        auto children = std::make_tuple(record<T, Symbols>(operand, inputs)...);
+        const T value = std::apply([](const auto&... child) { return node_value<Term, T>(child.value...); }, children);
+        return tape_node<T, decltype(record<T, Symbols>(operand, inputs))...>{value, children};
+      },
+      term.terms);
+  else if constexpr (type_list_contains_v<Term, Symbols>)
+    return tape_node<T>{inputs[type_list_index_v<Term, Symbols>], {}};
+  else if constexpr (is_constant_symbol_v<Term>)
+    return tape_node<T>{static_cast<T>(Term::value), {}};
+  else if constexpr (is_numeric_value_v<Term>)
+    return tape_node<T>{static_cast<T>(term), {}};
+  else
+    static_assert(sizeof(Term) == 0, "gradient: every symbol of the expression must be listed");
+}
+
+// Reverse sweep: adds the contributions of term, whose adjoint is given, to the gradient
+template<typename T, typename Symbols, typename Term, typename Node, std::size_t N>
+constexpr void sweep(const Term& term, const Node& node, const T& adjoint, std::array<T, N>& gradient)
+{
+  if constexpr (!is_symbolic_expression<Term>::value)
+    // a listed symbol, every other leaf is free of them
+    gradient[type_list_index_v<Term, Symbols>] += adjoint;
+  else
+  {
+    using op = expr_op_t<Term>;
+    constexpr std::size_t arity = std::tuple_size_v<decltype(term.terms)>;
+    const auto value = [&]<std::size_t I>(std::integral_constant<std::size_t, I>) -> const T& {
+      return std::get<I>(node.children).value;
+    };
+    // Pushes the adjoint of operand I, computed only when the operand depends on the symbols
+    const auto push = [&]<std::size_t I>(std::integral_constant<std::size_t, I>, const auto& operand_adjoint) {
+      using operand_t = std::tuple_element_t<I, std::remove_cvref_t<decltype(term.terms)>>;
+      if constexpr (contains_any_symbol_v<operand_t, Symbols>)
+        sweep<T, Symbols>(std::get<I>(term.terms), std::get<I>(node.children), static_cast<T>(operand_adjoint()),
+                          gradient);
+    };
+    constexpr auto at = []<std::size_t I>() { return std::integral_constant<std::size_t, I>{}; };
+
+    if constexpr (std::is_same_v<op, std::plus<void>>)
+      [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        (push(at.template operator()<Is>(), [&] { return adjoint; }), ...);
+      }(std::make_index_sequence<arity>{});
+    else if constexpr (std::is_same_v<op, std::minus<void>>)
+      [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        (push(at.template operator()<Is>(), [&] { return Is == 0 ? adjoint : -adjoint; }), ...);
+      }(std::make_index_sequence<arity>{});
+    else if constexpr (std::is_same_v<op, std::multiplies<void>>)
+      [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        // prefix[i] = v0 ... v(i-1) * adjoint, suffix[i] = v(i+1) ... v(n-1)
+        const std::array<T, arity> values{value(at.template operator()<Is>())...};
+        std::array<T, arity> prefix{};
+        std::array<T, arity> suffix{};
+        prefix[0] = adjoint;
+        suffix[arity - 1] = T{1};
+        for (std::size_t i = 1; i < arity; ++i)
+          prefix[i] = prefix[i - 1] * values[i - 1];
+        for (std::size_t i = arity - 1; i > 0; --i)
+          suffix[i - 1] = suffix[i] * values[i];
+        (push(at.template operator()<Is>(), [&] { return prefix[Is] * suffix[Is]; }), ...);
+      }(std::make_index_sequence<arity>{});
+    else if constexpr (std::is_same_v<op, std::divides<void>> && arity == 2)
+    {
+      // d(u / v) = du / v - (u / v) dv / v
+      const T scaled = adjoint / value(at.template operator()<1>());
+      push(at.template operator()<0>(), [&] { return scaled; });
+      push(at.template operator()<1>(), [&] { return -scaled * node.value; });
+    }
+    else if constexpr (has_constant_exponent<Term>::value)
+    {
+      constexpr auto c = expr_rhs_t<Term>::value;
+      push(at.template operator()<0>(), [&] {
+        return adjoint * static_cast<T>(c) * static_cast<T>(pow_by_constant<c - 1>(value(at.template operator()<0>())));
+      });
+    }
+    else if constexpr (std::is_same_v<op, power<void>> && arity == 2)
+    {
+      const T& u = value(at.template operator()<0>());
+      const T& e = value(at.template operator()<1>());
+      push(at.template operator()<0>(),
+           [&] { return adjoint * e * static_cast<T>(numeric_detail::pow_fn{}(u, e - T{1})); });
+      push(at.template operator()<1>(), [&] { return adjoint * node.value * static_cast<T>(natural_log{}(u)); });
+    }
+    else if constexpr (std::is_same_v<op, std::negate<void>>)
+      push(at.template operator()<0>(), [&] { return -adjoint; });
+    else if constexpr (arity == 1 && has_unary_derivative_v<op, T>)
+      push(at.template operator()<0>(), [&] {
+        const auto local = unary_derivative<op>{}(value(at.template operator()<0>()));
+        return adjoint * static_cast<T>(evaluate_term(local, positional_substitution<std::tuple<>>{}));
+      });
+    else
+      static_assert(sizeof(Term) == 0,
+                    "gradient: no rule for this operator, specialize unary_derivative for a unary one");
+  }
+}
+
+template<symbolic Expression, typename T, typename... Symbols>
+  requires(is_symbol_v<Symbols> && ...)
+struct gradient_formula
+{
+  static_assert(are_distinct_types_v<Symbols...>, "gradient: each symbol may only appear once");
+
+  using expression_type = Expression;
+  using symbols_type = std::tuple<Symbols...>;
+  static constexpr std::size_t arity = sizeof...(Symbols);
+
+  Expression expression;
+
+  constexpr gradient_formula(Expression expr) noexcept : expression(expr) {}
+
+  // Positional call: g(x_val, y_val, ...) returns the value and the gradient, in symbol order
+  template<typename... Values>
+    requires(sizeof...(Values) == arity)
+  constexpr gradient_result<T, arity> operator()(Values... values) const
+  {
+    const std::array<T, arity> inputs{static_cast<T>(values)...};
+    const auto tape = record<T, type_list<Symbols...>>(expression, inputs);
+    gradient_result<T, arity> result{tape.value, {}};
+    if constexpr (contains_any_symbol_v<Expression, type_list<Symbols...>>)
+      sweep<T, type_list<Symbols...>>(expression, tape, T{1}, result.gradient);
+    return result;
+  }
+};
+
+template<typename T = double, symbolic Expression, typename... Symbols>
+  requires(is_symbol_v<Symbols> && ...)
+constexpr auto gradient(const Expression& expr, const Symbols&...)
+{ return gradient_formula<Expression, T, std::remove_cvref_t<Symbols>...>(expr); }
+
+template<typename T = double, symbolic Expression, typename... Symbols>
+  requires(is_symbol_v<Symbols> && ...)
+constexpr auto gradient(const formula<Expression>& f, const Symbols&... symbols)
+{ return gradient<T>(f.expression, symbols...); }
+
+/*
+ *  Taylor Series
+ *  taylor(expr, x, x0, c<n>) is the expansion of expr about x0 to order n,
+ *  the sum of f^(k)(x0) (x - x0)^k / k!, returned in powers of x so that
+ *  horner() and estrin() evaluate it as a polynomial in x. Other symbols stay
+ *  in the coefficients. With x0 a constant_symbol, every coefficient that is a
+ *  constant expression is computed at compile time and becomes a
+ *  constant_symbol, exact while the derivatives at x0 are (1/3! is
+ *  c<rational{1, 6}>) and a double once they pass through exp, sin and the
+ *  like; with a numeric x0 the coefficients are computed once, here. Far from 0, expand a shifted symbol about 0
+ *  instead, taylor(expr(x = u + c<x0>), u, c<0>, c<n>), to keep the
+ *  coefficients small.
+ */
+
+// Left fold of simplify_expression(Op{}, ...)
+template<typename Op, typename First, typename... Rest>
+constexpr auto simplify_fold(const First& first, const Rest&... rest)
+{
+  if constexpr (sizeof...(Rest) == 0)
+    return first;
+  else
+    return [&](const auto& next, const auto&... others) {
+      return simplify_fold<Op>(simplify_expression(Op{}, first, next), others...);
+    }(rest...);
+}
+
+// term with Symbol replaced by value, rebuilt through simplify_* so that constants fold
+template<typename Symbol, typename Term, typename Value>
+constexpr auto replace_symbol(const Term& term, const Value& value)
+{
+  if constexpr (!contains_symbol_v<Term, Symbol>)
+    return term;
+  else if constexpr (!is_symbolic_expression<Term>::value)
+    return value;
+  else
+    return std::apply(
+      [&](const auto&... operand) {
+        using op = expr_op_t<Term>;
+        if constexpr (is_nary_operator_v<op>)
+          return symbolic_expression<op, decltype(replace_symbol<Symbol>(operand, value))...>(
+            replace_symbol<Symbol>(operand, value)...);
+        else if constexpr (std::is_same_v<op, power<void>>)
+          return simplify_pow(replace_symbol<Symbol>(operand, value)...);
+        else if constexpr (sizeof...(operand) == 1)
+          return simplify_expression(op{}, replace_symbol<Symbol>(operand, value)...);
+        else
+          return simplify_fold<op>(replace_symbol<Symbol>(operand, value)...);
+      },
+      term.terms);
+}
+
+// Trait: every leaf is a constant_symbol
+template<typename T>
+constexpr bool is_constant_term_v = is_constant_symbol_v<T>;
+template<typename Op, typename... Terms>
+constexpr bool is_constant_term_v<symbolic_expression<Op, Terms...>> = (is_constant_term_v<Terms> && ...);
+
+template<typename Term>
+constexpr double constant_term_value(const Term& term)
+{
+  if constexpr (is_constant_symbol_v<Term>)
+    return static_cast<double>(Term::value);
+  else
+    return std::apply(
+      [](const auto&... operand) { return node_value<Term, double>(constant_term_value(operand)...); }, term.terms);
+}
+
+// A constant expression whose value is known at compile time (not every operator is constexpr)
+template<typename Term>
+concept constant_foldable = is_constant_term_v<Term> && requires {
+  typename std::bool_constant<(constant_term_value(make_stateless<Term>()), true)>;
+};
+
+// The type arithmetic on V stays exact in: rational for integers and rationals
+template<auto V>
+using exact_value_t = std::conditional_t<std::is_floating_point_v<decltype(V)>, decltype(V), rational>;
+
+// Trait: Op folds two constant_symbols exactly (see fold_constants)
+template<typename Op>
+constexpr bool is_exact_constant_op_v = std::is_same_v<Op, std::plus<void>> || std::is_same_v<Op, std::minus<void>> ||
+                                        std::is_same_v<Op, std::multiplies<void>> ||
+                                        std::is_same_v<Op, std::divides<void>>;
+
+// c<B>^c<E>, E an integer, by repeated multiplication
+template<auto B, auto E>
+constexpr auto constant_power()
+{
+  constexpr auto value = [] {
+    const exact_value_t<B> base = static_cast<exact_value_t<B>>(B);
+    exact_value_t<B> result{1};
+    for (auto i = E < 0 ? -E : E; i > 0; --i)
+      result = result * base;
+    if constexpr (E < 0)
+      return exact_value_t<B>{1} / result;
+    else
+      return result;
+  }();
+  return normalized_constant<value>();
+}
+
+template<typename Op, typename Acc>
+constexpr auto fold_constant_operands(Acc acc)
+{ return acc; }
+template<typename Op, typename Acc, typename Next, typename... Rest>
+constexpr auto fold_constant_operands(Acc acc, Next next, Rest... rest)
+{ return fold_constant_operands<Op>(fold_constants(Op{}, acc, next), rest...); }
+
+// term as one constant_symbol when it is constant: exact through + - * / and
+// integer powers of integers and rationals, a double through anything else
+template<typename Term>
+constexpr auto fold_constant(const Term& term)
+{
+  if constexpr (is_constant_symbol_v<Term>)
+    return normalized_constant<Term::value>();
+  else if constexpr (!is_constant_term_v<Term>)
+    return term;
+  else
+  {
+    using op = expr_op_t<Term>;
+    const auto folded = std::apply([](const auto&... operand) { return std::tuple(fold_constant(operand)...); }, term.terms);
+    using folded_t = std::remove_cvref_t<decltype(folded)>;
+    constexpr std::size_t arity = std::tuple_size_v<folded_t>;
+    constexpr bool all_constant = []<std::size_t... Is>(std::index_sequence<Is...>) {
+      return (is_constant_symbol_v<std::tuple_element_t<Is, folded_t>> && ...);
+    }(std::make_index_sequence<arity>{});
+    constexpr bool exact = [] {
+      if constexpr (!all_constant)
+        return false;
+      else if constexpr (is_exact_constant_op_v<op> && arity >= 2)
+        return []<std::size_t... Is>(std::index_sequence<Is...>) {
+          return !std::is_same_v<op, std::divides<void>> || ((std::tuple_element_t<Is + 1, folded_t>::value != 0) && ...);
+        }(std::make_index_sequence<arity - 1>{});
+      else if constexpr (std::is_same_v<op, std::negate<void>>)
+        return true;
+      else if constexpr (std::is_same_v<op, power<void>> && arity == 2)
+      {
+        constexpr auto base = std::tuple_element_t<0, folded_t>::value;
+        constexpr auto exponent = std::tuple_element_t<1, folded_t>::value;
+        return is_integer_constant_v<exponent> && !(base == 0 && exponent < 0);
+      }
+      else
+        return false;
+    }();
+    if constexpr (exact && std::is_same_v<op, std::negate<void>>)
+      return fold_constants(std::minus<void>{}, constant_symbol<0>{}, std::get<0>(folded));
+    else if constexpr (exact && std::is_same_v<op, power<void>>)
+      return constant_power<std::tuple_element_t<0, folded_t>::value, std::tuple_element_t<1, folded_t>::value>();
+    else if constexpr (exact)
+      return std::apply([](const auto&... operand) { return fold_constant_operands<op>(operand...); }, folded);
+    else if constexpr (constant_foldable<Term>)
+      return normalized_constant<constant_term_value(make_stateless<Term>())>();
+    else
+      return term;
+  }
+}
+
+// C(k, m) (-x0)^(k - m) / k!: the share of x^m in (x - x0)^k / k!
+template<typename T>
+constexpr T shifted_power_weight(std::size_t k, std::size_t m, const T& x0)
+{
+  T weight{1};
+  for (std::size_t i = 1; i <= k - m; ++i)
+    weight = weight * -x0 / static_cast<T>(i);
+  for (std::size_t i = 1; i <= m; ++i)
+    weight = weight / static_cast<T>(i);
+  return weight;
+}
+
+// Derivatives 0 to Order of term, in a tuple
+template<typename Symbol, std::size_t Order, typename Term>
+constexpr auto successive_derivatives(const Term& term)
+{
+  if constexpr (Order == 0)
+    return std::make_tuple(term);
+  else
+    return std::tuple_cat(std::make_tuple(term), successive_derivatives<Symbol, Order - 1>(derivative_of<Symbol>(term)));
+}
+
+// Coefficient of x^M, from the derivatives at x0
+template<typename Symbol, std::size_t M, typename Derivatives, typename Point>
+constexpr auto taylor_coefficient(const Derivatives& derivatives, const Point& x0)
+{
+  constexpr std::size_t order = std::tuple_size_v<Derivatives> - 1;
+  return [&]<std::size_t... Ks>(std::index_sequence<Ks...>) {
+    if constexpr (is_constant_symbol_v<Point>)
+      return fold_constant(simplify_sum(simplify_mul(
+        fold_constant(replace_symbol<Symbol>(std::get<M + Ks>(derivatives), x0)),
+        normalized_constant<shifted_power_weight(M + Ks, M, static_cast<exact_value_t<Point::value>>(Point::value))>())...));
+    else
+      return simplify_sum(simplify_mul(evaluate_term(std::get<M + Ks>(derivatives), substitution(Symbol{} = x0)),
+                                       shifted_power_weight(M + Ks, M, static_cast<double>(x0)))...);
+  }(std::make_index_sequence<order - M + 1>{});
+}
+
+template<symbolic Expression, typename Symbol, typename Point, auto Order>
+  requires(is_symbol_v<Symbol> && (is_constant_symbol_v<Point> || is_numeric_value_v<Point>))
+constexpr auto taylor(const Expression& expr, const Symbol&, const Point& x0, constant_symbol<Order>)
+{
+  static_assert(std::is_integral_v<decltype(Order)> && Order >= 0, "taylor: the order is a non-negative integer");
+  using symbol_type = std::remove_cvref_t<Symbol>;
+  const auto derivatives = successive_derivatives<symbol_type, static_cast<std::size_t>(Order)>(expr);
+  return [&]<std::size_t... Ms>(std::index_sequence<Ms...>) {
+    return simplify_sum(simplify_mul(taylor_coefficient<symbol_type, Ms>(derivatives, x0),
+                                     simplify_pow(symbol_type{}, constant_symbol<static_cast<int>(Ms)>{}))...);
+  }(std::make_index_sequence<static_cast<std::size_t>(Order) + 1>{});
+}
+
+template<symbolic Expression, typename Symbol, typename Point, auto Order>
+  requires(is_symbol_v<Symbol> && (is_constant_symbol_v<Point> || is_numeric_value_v<Point>))
+constexpr auto taylor(const formula<Expression>& f, const Symbol& symbol, const Point& x0, constant_symbol<Order> order)
+{ return formula{taylor(f.expression, symbol, x0, order)}; }
+
+/*
+ *  Integration
+ *  integrate(expr, x) is an antiderivative of expr, built at compile time for
+ *  the expressions with one in closed form: sums of k * x^n, n a
+ *  constant_symbol (negative or fractional too, log(x) for n = -1), and k free
+ *  of x, other symbols included. Constant coefficients fold with 1 / (n + 1)
+ *  into one constant_symbol, exactly for integer and rational coefficients.
+ *  integrate(expr, x, a, b) is the definite integral, a constant_symbol when
+ *  the bounds are constant_symbols and expr has no other symbol, exact as
+ *  well (the integral of x^2 from 0 to 1 is c<rational{1, 3}>), a value when
+ *  they are numbers and an expression in the remaining symbols otherwise.
+ */
+
+template<typename Symbol, typename Term>
+constexpr auto antiderivative_of(const Term& term);
+
+// k * x^(n + 1) / (n + 1), k * log(x) for n = -1
+template<typename Symbol, auto N, typename Coefficient>
+constexpr auto integrate_monomial(const Coefficient& k)
+{
+  if constexpr (N == -1)
+    return simplify_mul(k, simplify_log(Symbol{}));
+  else
+  {
+    static_assert(std::is_arithmetic_v<decltype(N)> || is_rational_v<decltype(N)>,
+                  "integrate: exponents are arithmetic or rational constant_symbols");
+    return simplify_mul(fold_constant(simplify_div(k, normalized_constant<N + 1>())),
+                        simplify_pow(Symbol{}, normalized_constant<N + 1>()));
+  }
+}
+
+// Trait: Term is Symbol^c
+template<typename Symbol, typename Term>
+constexpr bool is_monomial_power_v = false;
+template<typename Symbol, typename Exp>
+constexpr bool is_monomial_power_v<Symbol, symbolic_expression<power<void>, Symbol, Exp>> = is_constant_symbol_v<Exp>;
+
+// k * factor, k free of the symbol
+template<typename Symbol, typename Factor, typename Coefficient>
+constexpr auto integrate_scaled(const Factor& factor, const Coefficient& k)
+{
+  if constexpr (std::is_same_v<Factor, Symbol>)
+    return integrate_monomial<Symbol, 1>(k);
+  else if constexpr (is_monomial_power_v<Symbol, Factor>)
+    return integrate_monomial<Symbol, expr_rhs_t<Factor>::value>(k);
+  else
+    return simplify_mul(k, antiderivative_of<Symbol>(factor));
+}
+
+// A product with one factor in the symbol, the others its coefficient
+template<typename Symbol, typename... Terms>
+constexpr auto integrate_product(const std::tuple<Terms...>& terms)
+{
+  constexpr std::size_t dependent = (std::size_t{contains_symbol_v<Terms, Symbol>} + ...);
+  static_assert(dependent == 1, "integrate: a product may have only one factor in the symbol");
+  constexpr std::size_t index = [] {
+    std::size_t i = 0;
+    ((contains_symbol_v<Terms, Symbol> ? false : (++i, true)) && ...);
+    return i;
+  }();
+  return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+    const auto coefficient = simplify_product(constant_symbol<1>{}, [&]() {
+      if constexpr (Is == index)
+        return constant_symbol<1>{};
+      else
+        return std::get<Is>(terms);
+    }()...);
+    return integrate_scaled<Symbol>(std::get<index>(terms), coefficient);
+  }(std::index_sequence_for<Terms...>{});
+}
+
+// u / v: the antiderivative of u over v for v free of the symbol, u * x^-n for v = x^n
+template<typename Symbol, typename Numerator, typename Denominator>
+constexpr auto integrate_quotient(const Numerator& u, const Denominator& v)
+{
+  if constexpr (!contains_symbol_v<Denominator, Symbol>)
+    return simplify_div(antiderivative_of<Symbol>(u), v);
+  else if constexpr (!contains_symbol_v<Numerator, Symbol> && std::is_same_v<Denominator, Symbol>)
+    return integrate_monomial<Symbol, -1>(u);
+  else if constexpr (!contains_symbol_v<Numerator, Symbol> && is_monomial_power_v<Symbol, Denominator>)
+    return integrate_monomial<Symbol, -expr_rhs_t<Denominator>::value>(u);
+  else
+    static_assert(sizeof(Denominator) == 0, "integrate: no closed form for this quotient");
+}
+
+template<typename Symbol, typename Term>
+constexpr auto antiderivative_of(const Term& term)
+{
+  if constexpr (!contains_symbol_v<Term, Symbol>)
+    return simplify_mul(term, Symbol{});
+  else if constexpr (!is_symbolic_expression<Term>::value)
+    // the symbol itself
+    return integrate_monomial<Symbol, 1>(constant_symbol<1>{});
+  else
+  {
+    using op = expr_op_t<Term>;
+    constexpr std::size_t arity = std::tuple_size_v<decltype(term.terms)>;
+    if constexpr (std::is_same_v<op, std::plus<void>>)
+      return std::apply([](const auto&... operand) { return simplify_sum(antiderivative_of<Symbol>(operand)...); },
+                        term.terms);
+    else if constexpr (std::is_same_v<op, std::minus<void>>)
+      return std::apply(
+        [](const auto& first, const auto&... rest) {
+          return simplify_sub(antiderivative_of<Symbol>(first), simplify_sum(antiderivative_of<Symbol>(rest)...));
+        },
+        term.terms);
+    else if constexpr (std::is_same_v<op, std::multiplies<void>>)
+      return integrate_product<Symbol>(term.terms);
+    else if constexpr (std::is_same_v<op, std::divides<void>> && arity == 2)
+      return integrate_quotient<Symbol>(std::get<0>(term.terms), std::get<1>(term.terms));
+    else if constexpr (is_monomial_power_v<Symbol, Term>)
+      return integrate_monomial<Symbol, expr_rhs_t<Term>::value>(constant_symbol<1>{});
+    else if constexpr (std::is_same_v<op, std::negate<void>>)
+      return simplify_neg(antiderivative_of<Symbol>(std::get<0>(term.terms)));
+    else
+      static_assert(sizeof(Term) == 0, "integrate: no closed form, only sums of k * x^n are integrated");
+  }
+}
+
+// F(bound): folded at compile time for a constant_symbol, evaluated for a number
+template<typename Symbol, typename Antiderivative, typename Bound>
+constexpr auto antiderivative_at(const Antiderivative& antiderivative, const Bound& bound)
+{
+  if constexpr (is_numeric_value_v<Bound>)
+    return evaluate_term(antiderivative, substitution(Symbol{} = bound));
+  else
+    return fold_constant(replace_symbol<Symbol>(antiderivative, bound));
+}
+
+template<symbolic Expression, typename Symbol>
+  requires is_symbol_v<Symbol>
+constexpr auto integrate(const Expression& expr, const Symbol&)
+{ return antiderivative_of<std::remove_cvref_t<Symbol>>(expr); }
+
+template<symbolic Expression, typename Symbol>
+  requires is_symbol_v<Symbol>
+constexpr auto integrate(const formula<Expression>& f, const Symbol& symbol)
+{ return formula{integrate(f.expression, symbol)}; }
+
+template<symbolic Expression, typename Symbol, typename Lower, typename Upper>
+  requires(is_symbol_v<Symbol> && (is_constant_symbol_v<Lower> || is_numeric_value_v<Lower> || symbolic<Lower>) &&
+           (is_constant_symbol_v<Upper> || is_numeric_value_v<Upper> || symbolic<Upper>))
+constexpr auto integrate(const Expression& expr, const Symbol& symbol, const Lower& a, const Upper& b)
+{
+  using symbol_type = std::remove_cvref_t<Symbol>;
+  const auto antiderivative = integrate(expr, symbol);
+  return fold_constant(simplify_sub(antiderivative_at<symbol_type>(antiderivative, b),
+                                    antiderivative_at<symbol_type>(antiderivative, a)));
+}
+
+template<symbolic Expression, typename Symbol, typename Lower, typename Upper>
+  requires(is_symbol_v<Symbol> && (is_constant_symbol_v<Lower> || is_numeric_value_v<Lower> || symbolic<Lower>) &&
+           (is_constant_symbol_v<Upper> || is_numeric_value_v<Upper> || symbolic<Upper>))
+constexpr auto integrate(const formula<Expression>& f, const Symbol& symbol, const Lower& a, const Upper& b)
+{ return integrate(f.expression, symbol, a, b); }
+
+} // end namespace lam::symbols
@@ -0,0 +1,179 @@
+/*
+ * Provided under CC0 1.0 Universal – Public Domain Dedication license
+ * Original Author: Vincent Reverdy (LAPP, France)
+ * Source: CppCon 2023 "Symbolic Calculus for High-performance Computing From Scratch Using C++23"
+ */
+
+/*
+ * lam.symbols:chains
+ * Description: Multiplication schedules for constant integer powers.
+ * Content: addition_chain, make_addition_chain, power_sequence.
+ * Extending Author: Colin Ford
+ */
+
+module;
+
+import std;
+
+export module lam.symbols:chains;
+import :traits;
+
+export namespace lam::symbols
+{
+
+/*
+ *  Addition Chains
+ *  1 = e0 < e1 < ... where every ek is the sum of two earlier elements:
+ *  x^ek = x^e(lhs) * x^e(rhs), one multiplication per element. A chain built
+ *  for several exponents (an addition sequence) computes all of them, so
+ *  x^2, x^3 and x^5 take three multiplications together: 1, 2, 3, 5.
+ */
+
+struct addition_chain
+{
+  static constexpr std::size_t capacity = 64;
+
+  std::array<std::size_t, capacity> exponents{1};
+  std::array<std::size_t, capacity> lhs{};
+  std::array<std::size_t, capacity> rhs{};
+  std::size_t size = 1;
+
+  // Position of exponent n (size if absent)
+  constexpr std::size_t index_of(std::size_t n) const
+  {
+    for (std::size_t k = 0; k < size; ++k)
+      if (exponents[k] == n)
+        return k;
+    return size;
+  }
+
+  constexpr bool contains(std::size_t n) const { return index_of(n) < size; }
+
+  constexpr std::size_t largest() const
+  { return *std::ranges::max_element(exponents.begin(), exponents.begin() + size); }
+
+  constexpr void push(std::size_t i, std::size_t j)
+  {
+    if (size == capacity)
+      throw "addition_chain: too many multiplications"; // not a constant expression
+    exponents[size] = exponents[i] + exponents[j];
+    lhs[size] = i;
+    rhs[size] = j;
+    ++size;
+  }
+};
+
+namespace chain_detail
+{
+// Exponents up to this one get a shortest chain, searched; larger ones the binary method
+inline constexpr std::size_t searched_exponent_limit = 32;
+
+// Multiplications of the left to right binary method
+constexpr std::size_t binary_steps(std::size_t n)
+{
+  std::size_t steps = 0;
+  for (std::size_t bit = std::bit_width(n) - 1; bit-- > 0;)
+    steps += 1 + ((n >> bit) & 1);
+  return steps;
+}
+
+// Depth first: append at most depth elements, increasing, above floor; after the
+// first one, star steps only (the last element plus any other), which are
+// shortest for every exponent searched. top is the largest element. Leaves the
+// chain as it was when nothing is found
+constexpr bool search(addition_chain& chain, std::size_t n, std::size_t depth, std::size_t floor, std::size_t top)
+{
+  const std::size_t last = floor == 0 ? 0 : chain.size - 1;
+  for (std::size_t i = chain.size; i-- > last;)
+    for (std::size_t j = i + 1; j-- > 0;)
+    {
+      const std::size_t sum = chain.exponents[i] + chain.exponents[j];
+      if (sum == n)
+      {
+        chain.push(i, j);
+        return true;
+      }
+      // the remaining depth - 1 doublings must still reach n
+      if (depth == 1 || sum > n || sum <= floor || (std::max(top, sum) << (depth - 1)) < n || chain.contains(sum))
+        continue;
+      chain.push(i, j);
+      if (search(chain, n, depth - 1, sum, std::max(top, sum)))
+        return true;
+      --chain.size;
+    }
+  return false;
+}
+
+// Square and multiply, reusing every element the chain already has
+constexpr void extend_binary(addition_chain& chain, std::size_t n)
+{
+  std::size_t power = 1;
+  for (std::size_t bit = std::bit_width(n) - 1; bit-- > 0;)
+  {
+    const std::size_t k = chain.index_of(power);
+    power *= 2;
+    if (!chain.contains(power))
+      chain.push(k, k);
+    if ((n >> bit) & 1)
+    {
+      const std::size_t m = chain.index_of(power);
+      power += 1;
+      if (!chain.contains(power))
+        chain.push(m, 0);
+    }
+  }
+}
+
+constexpr void extend(addition_chain& chain, std::size_t n)
+{
+  if (chain.contains(n))
+    return;
+  if (n <= searched_exponent_limit)
+    for (std::size_t depth = 1; depth < binary_steps(n); ++depth)
+      if ((chain.largest() << depth) >= n && search(chain, n, depth, 0, chain.largest()))
+        return;
+  extend_binary(chain, n);
+}
+} // namespace chain_detail
+
+// A chain holding every target, extended one target at a time, smallest first
+template<std::size_t N>
+constexpr addition_chain make_addition_chain(std::array<std::size_t, N> targets)
+{
+  std::ranges::sort(targets);
+  addition_chain chain;
+  for (std::size_t n : targets)
+    if (n > 0)
+      chain_detail::extend(chain, n);
+  return chain;
+}
+
+/*
+ *  power_sequence<2, 3, 5>::powers(x) is {x, x^2, x^3, x^5}, straight line
+ *  code with constant indices, so the compiler keeps every power in a register
+ *  and drops the ones nobody reads.
+ */
+
+template<std::size_t... Exponents>
+struct power_sequence
+{
+  static constexpr addition_chain chain = make_addition_chain(std::array<std::size_t, sizeof...(Exponents)>{Exponents...});
+
+  template<typename T>
+  static constexpr std::array<T, chain.size> powers(const T& x)
+  {
+    std::array<T, chain.size> values{};
+    values[0] = x;
+    [&]<std::size_t... Ks>(std::index_sequence<Ks...>) {
+      ((values[Ks + 1] = values[chain.lhs[Ks + 1]] * values[chain.rhs[Ks + 1]]), ...);
+    }(std::make_index_sequence<chain.size - 1>{});
+    return values;
+  }
+
+  template<std::size_t N, typename T>
+    requires(chain.contains(N))
+  static constexpr T power(const T& x)
+  { return powers(x)[chain.index_of(N)]; }
+};
+
+} // end namespace lam::symbols
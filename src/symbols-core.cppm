@@ -7,7 +7,7 @@
 /*
  * lam.symbols:core
  * Description: The atomic units of the symbolic language.
- * Content: symbol, constant_symbol, symbol_id, symbol_binder, substitution.
+ * Content: symbol, ordered_symbol, constant_symbol, rational, symbol_id, symbol_binder, substitution.
  * Note: Contains cyclic dependencies resolved via recursive templates.
  * Extending Author: Colin Ford
  */
@@ -22,13 +22,22 @@ import :traits;
 export namespace lam::symbols
 {
 
-template <typename>
+template <typename Tag>
 struct symbol_id
 {
+  using tag_type = Tag;
   static constexpr auto singleton = []{};
   static constexpr const void* address = std::addressof(singleton);
 };
 
+// A tag giving a symbol an explicit place in the operand order of sums and
+// products; any tag with a static constexpr std::size_t order does the same
+template <std::size_t N>
+struct symbol_order
+{
+  static constexpr std::size_t order = N;
+};
+
 template <typename Lhs, typename Rhs>
 constexpr std::strong_ordering
 operator<=>(symbol_id<Lhs>, symbol_id<Rhs>)
@@ -78,6 +87,10 @@ struct unconstrained
 template <typename... Binders>
 struct substitution; // need (this) forward declaration
 
+// Positional substitution: values bound by position to a fixed symbol list
+template <typename Symbols, typename... Values>
+struct positional_substitution; // forward declaration as well
+
 template <typename Trait = unconstrained,
           auto Id = symbol_id<decltype([]{})>{}>
 struct symbol
@@ -108,6 +121,17 @@ struct symbol
     }
   }
 
+  // Positional lookup: the index is resolved once, from the symbol list
+  template <typename Symbols, typename... Values>
+  constexpr auto operator()(const positional_substitution<Symbols, Values...>& s) const
+  {
+    constexpr auto idx = positional_substitution<Symbols, Values...>::template index_of<symbol>;
+    if constexpr (idx < sizeof...(Values))
+      return std::get<idx>(s.values);
+    else
+      return *this;
+  }
+
   // Convenience operator for direct substitution
   template <class... Args>
   constexpr auto operator()(Args... args) const noexcept
@@ -121,21 +145,166 @@ struct symbol
 template <typename T, auto Id>
 struct is_symbolic<symbol<T, Id>> : std::true_type {};
 
+// ordered_symbol<0> a; ordered_symbol<1> b; a + b and b + a are one type.
+// Every N names one symbol, so each declaration needs an N of its own.
+template <std::size_t N, typename Trait = unconstrained>
+using ordered_symbol = symbol<Trait, symbol_id<symbol_order<N>>{}>;
+
+/*
+ *  Exact Rationals
+ *  rational{1, 3} is a structural type, so constant_symbol<rational{1, 3}> is
+ *  the exact 1/3, like std::ratio<1, 3> but a value. It is kept reduced with a
+ *  positive denominator, so equal rationals are one constant_symbol type.
+ *  Arithmetic with integers stays exact, with a floating value it is floating;
+ *  an overflow is not a constant expression, so a fold that would overflow
+ *  does not compile. A constant_symbol holding a rational is converted to the
+ *  type of the bound values only when it is evaluated (see rational_value_t).
+ */
+
+namespace rational_detail
+{
+inline constexpr std::int64_t max = std::numeric_limits<std::int64_t>::max();
+inline constexpr std::int64_t min = std::numeric_limits<std::int64_t>::min();
+
+constexpr std::int64_t checked_add(std::int64_t a, std::int64_t b)
+{
+  if ((b > 0 && a > max - b) || (b < 0 && a < min - b))
+    throw "rational: overflow"; // not a constant expression
+  return a + b;
+}
+
+constexpr std::int64_t checked_mul(std::int64_t a, std::int64_t b)
+{
+  if (a == 0 || b == 0)
+    return 0;
+  if (a > 0 ? (b > 0 ? a > max / b : b < min / a) : (b > 0 ? a < min / b : b < max / a))
+    throw "rational: overflow"; // not a constant expression
+  return a * b;
+}
+} // namespace rational_detail
+
+struct rational
+{
+  std::int64_t num = 0;
+  std::int64_t den = 1;
+
+  constexpr rational() = default;
+
+  template <std::integral N, std::integral D = N>
+  constexpr rational(N numerator, D denominator = D{1})
+  {
+    if (!std::in_range<std::int64_t>(numerator) || !std::in_range<std::int64_t>(denominator))
+      throw "rational: overflow"; // not a constant expression
+    if (denominator == 0)
+      throw "rational: zero denominator"; // not a constant expression
+    const std::int64_t divisor = std::gcd(static_cast<std::int64_t>(numerator), static_cast<std::int64_t>(denominator));
+    num = static_cast<std::int64_t>(numerator) / divisor;
+    den = static_cast<std::int64_t>(denominator) / divisor;
+    if (den < 0)
+    {
+      num = rational_detail::checked_mul(num, -1);
+      den = rational_detail::checked_mul(den, -1);
+    }
+  }
+
+  template <std::intmax_t N, std::intmax_t D>
+  constexpr rational(std::ratio<N, D>) : rational(N, D) {}
+
+  template <typename T>
+  requires std::is_arithmetic_v<T>
+  explicit constexpr operator T() const { return static_cast<T>(num) / static_cast<T>(den); }
+
+  friend constexpr rational operator-(const rational& r) { return {rational_detail::checked_mul(r.num, -1), r.den}; }
+
+  friend constexpr rational operator+(const rational& l, const rational& r)
+  {
+    using namespace rational_detail;
+    const std::int64_t common = std::gcd(l.den, r.den);
+    return {checked_add(checked_mul(l.num, r.den / common), checked_mul(r.num, l.den / common)),
+            checked_mul(l.den / common, r.den)};
+  }
+  friend constexpr rational operator-(const rational& l, const rational& r) { return l + -r; }
+  friend constexpr rational operator*(const rational& l, const rational& r)
+  {
+    using namespace rational_detail;
+    // cross reduced first, so only a product that does not fit overflows
+    const std::int64_t a = std::gcd(l.num, r.den);
+    const std::int64_t b = std::gcd(r.num, l.den);
+    return {checked_mul(l.num / a, r.num / b), checked_mul(l.den / b, r.den / a)};
+  }
+  friend constexpr rational operator/(const rational& l, const rational& r) { return l * rational(r.den, r.num); }
+
+  friend constexpr bool operator==(const rational&, const rational&) = default;
+  friend constexpr std::strong_ordering operator<=>(const rational& l, const rational& r)
+  {
+    return rational_detail::checked_mul(l.num, r.den) <=> rational_detail::checked_mul(r.num, l.den);
+  }
+
+  // with a floating value, floating arithmetic in its type
+  template <std::floating_point F>
+  friend constexpr F operator+(const rational& l, F r) { return static_cast<F>(l) + r; }
+  template <std::floating_point F>
+  friend constexpr F operator+(F l, const rational& r) { return l + static_cast<F>(r); }
+  template <std::floating_point F>
+  friend constexpr F operator-(const rational& l, F r) { return static_cast<F>(l) - r; }
+  template <std::floating_point F>
+  friend constexpr F operator-(F l, const rational& r) { return l - static_cast<F>(r); }
+  template <std::floating_point F>
+  friend constexpr F operator*(const rational& l, F r) { return static_cast<F>(l) * r; }
+  template <std::floating_point F>
+  friend constexpr F operator*(F l, const rational& r) { return l * static_cast<F>(r); }
+  template <std::floating_point F>
+  friend constexpr F operator/(const rational& l, F r) { return static_cast<F>(l) / r; }
+  template <std::floating_point F>
+  friend constexpr F operator/(F l, const rational& r) { return l / static_cast<F>(r); }
+  template <std::floating_point F>
+  friend constexpr bool operator==(const rational& l, F r) { return static_cast<F>(l) == r; }
+  template <std::floating_point F>
+  friend constexpr std::partial_ordering operator<=>(const rational& l, F r) { return static_cast<F>(l) <=> r; }
+};
+
+template <typename T>
+inline constexpr bool is_rational_v = std::is_same_v<std::remove_cvref_t<T>, rational>;
+
+// The type a rational evaluates to beside bound values of types Values...:
+// their common floating type, double for integers and other numeric values
+template <typename... Values>
+struct rational_value { using type = double; };
+template <std::floating_point... Values>
+requires(sizeof...(Values) > 0)
+struct rational_value<Values...> { using type = std::common_type_t<Values...>; };
+template <typename... Values>
+using rational_value_t = typename rational_value<std::remove_cvref_t<Values>...>::type;
+
 template <auto Value>
 struct constant_symbol
 {
   using type = decltype(Value);
   static constexpr type value = Value;
 
+  // value as it is evaluated with bound values of types Values...
+  template <typename... Values>
+  static constexpr auto evaluated()
+  {
+    if constexpr (is_rational_v<type>)
+      return static_cast<rational_value_t<Values...>>(value);
+    else
+      return value;
+  }
+
   template<typename... Binders>
   constexpr auto operator()(const substitution<Binders...>& s) const
-  { return value; /* <–– everything happens here */ }
+  { return evaluated<typename std::remove_reference_t<Binders>::value_type...>(); /* <–– everything happens here */ }
+
+  template <typename Symbols, typename... Values>
+  constexpr auto operator()(const positional_substitution<Symbols, Values...>&) const
+  { return evaluated<Values...>(); }
 
   // Convenience operator for direct substitution (e.g. 0(x=1)) usually typical for generic code
   template <class... Args>
   constexpr auto operator()(Args... args) const noexcept
   { 
-    return value; 
+    return evaluated<typename Args::value_type...>(); 
     // Note: we just ignore args because it's a constant. 
     // No need to build substitution object.
   }
@@ -210,4 +379,41 @@ struct substitution_element
 };
 // END substitution
 
+/*
+ *  Positional substitution
+ *  A flat tuple of values matched by position against a list of symbols.
+ *  No binder is built: the index of each symbol is a compile-time constant.
+ */
+template <typename... Symbols, typename... Values>
+struct positional_substitution<std::tuple<Symbols...>, Values...>
+{
+  static_assert(sizeof...(Symbols) == sizeof...(Values),
+                "positional_substitution needs exactly one value per symbol");
+
+  // Index of Symbol in the symbol list (sizeof...(Symbols) if absent)
+  template <typename Symbol>
+  static constexpr std::size_t index_of = []{
+    std::size_t found = sizeof...(Symbols);
+    std::size_t i = 0;
+    ((std::is_same_v<Symbols, Symbol> && found == sizeof...(Symbols) ? (found = i) : 0, ++i), ...);
+    return found;
+  }();
+
+  std::tuple<Values...> values;
+
+  constexpr positional_substitution(const Values&... v) : values(v...) {}
+};
+
+// Trait: anything a symbolic object can be evaluated against
+template <typename T>
+struct is_substitution : std::false_type {};
+template <typename... Binders>
+struct is_substitution<substitution<Binders...>> : std::true_type {};
+template <typename Symbols, typename... Values>
+struct is_substitution<positional_substitution<Symbols, Values...>> : std::true_type {};
+template <typename T>
+inline constexpr bool is_substitution_v = is_substitution<std::remove_cvref_t<T>>::value;
+template <typename T>
+concept substitution_like = is_substitution_v<T>;
+
 } // end namespace lam::symbols
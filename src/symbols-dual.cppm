@@ -0,0 +1,263 @@
+/*
+ * Provided under CC0 1.0 Universal – Public Domain Dedication license
+ * Original Author: Vincent Reverdy (LAPP, France)
+ * Source: CppCon 2023 "Symbolic Calculus for High-performance Computing From Scratch Using C++23"
+ */
+
+/*
+ * lam.symbols:dual
+ * Description: Forward mode differentiation at evaluation time.
+ * Content: dual<T, N>, a value and N tangents, with its arithmetic and elementary
+ *          functions; seed_dual for the inputs, jvp for compiled formulas, colored_jacobian
+ *          for compiled bundles.
+ * Note: a dual is a numeric_value, so binding one folds through the simplifier
+ *       like a double and full substitution returns a dual.
+ * Extending Author: Colin Ford
+ */
+
+module;
+
+import std;
+
+export module lam.symbols:dual;
+import :traits;
+import :core;
+import :engine;
+import :bundle;
+import :calculus;
+
+export namespace lam::symbols
+{
+
+/*
+ *  Dual Numbers
+ *  dual<T, N> carries a value and the N directional derivatives of that value.
+ *  Binding x = seed_dual<2>(1.5, 0) and y = seed_dual<2>(0.5, 1) evaluates an
+ *  expression together with its derivatives along x and y, one pass whatever
+ *  the size of the expression, where derivative() builds a new expression type
+ *  per direction. The tangents are contiguous, every rule is a loop over them.
+ *  Scalars of type T combine with a dual without touching the tangents.
+ */
+
+template<typename T, std::size_t N = 1>
+struct dual
+{
+  using value_type = T;
+  static constexpr std::size_t tangents = N;
+
+  T value{};
+  std::array<T, N> tangent{};
+
+  constexpr dual() = default;
+  // A constant: every tangent is zero
+  constexpr dual(const T& v) : value(v) {}
+  constexpr dual(const T& v, const std::array<T, N>& t) : value(v), tangent(t) {}
+
+  // Chain rule for a unary function f at value, with f(value) and f'(value) given
+  constexpr dual chain(const T& f, const T& df) const
+  {
+    dual result{f};
+    for (std::size_t i = 0; i < N; ++i)
+      result.tangent[i] = df * tangent[i];
+    return result;
+  }
+
+  friend constexpr dual operator+(const dual& l, const dual& r)
+  {
+    dual result{l.value + r.value};
+    for (std::size_t i = 0; i < N; ++i)
+      result.tangent[i] = l.tangent[i] + r.tangent[i];
+    return result;
+  }
+  friend constexpr dual operator+(const dual& l, const T& r) { return {l.value + r, l.tangent}; }
+  friend constexpr dual operator+(const T& l, const dual& r) { return {l + r.value, r.tangent}; }
+
+  friend constexpr dual operator-(const dual& l, const dual& r)
+  {
+    dual result{l.value - r.value};
+    for (std::size_t i = 0; i < N; ++i)
+      result.tangent[i] = l.tangent[i] - r.tangent[i];
+    return result;
+  }
+  friend constexpr dual operator-(const dual& l, const T& r) { return {l.value - r, l.tangent}; }
+  friend constexpr dual operator-(const T& l, const dual& r) { return (-r) + l; }
+  friend constexpr dual operator-(const dual& d) { return d.chain(-d.value, T{-1}); }
+
+  friend constexpr dual operator*(const dual& l, const dual& r)
+  {
+    dual result{l.value * r.value};
+    for (std::size_t i = 0; i < N; ++i)
+      result.tangent[i] = l.tangent[i] * r.value + l.value * r.tangent[i];
+    return result;
+  }
+  friend constexpr dual operator*(const dual& l, const T& r) { return l.chain(l.value * r, r); }
+  friend constexpr dual operator*(const T& l, const dual& r) { return r.chain(l * r.value, l); }
+
+  // d(u / v) = (du - (u / v) dv) / v
+  friend constexpr dual operator/(const dual& l, const dual& r)
+  {
+    const T inverse = T{1} / r.value;
+    dual result{l.value * inverse};
+    for (std::size_t i = 0; i < N; ++i)
+      result.tangent[i] = (l.tangent[i] - result.value * r.tangent[i]) * inverse;
+    return result;
+  }
+  friend constexpr dual operator/(const dual& l, const T& r)
+  {
+    const T inverse = T{1} / r;
+    return l.chain(l.value * inverse, inverse);
+  }
+  friend constexpr dual operator/(const T& l, const dual& r)
+  {
+    const T quotient = l / r.value;
+    return r.chain(quotient, -quotient / r.value);
+  }
+
+  friend constexpr bool operator==(const dual&, const dual&) = default;
+
+  // Elementary functions, found by argument dependent lookup from the simplifier
+  friend constexpr dual sqrt(const dual& d)
+  {
+    using std::sqrt;
+    const T root = sqrt(d.value);
+    return d.chain(root, T{1} / (T{2} * root));
+  }
+  friend constexpr dual cbrt(const dual& d)
+  {
+    using std::cbrt;
+    const T root = cbrt(d.value);
+    return d.chain(root, T{1} / (T{3} * root * root));
+  }
+  friend constexpr dual exp(const dual& d)
+  {
+    using std::exp;
+    const T e = exp(d.value);
+    return d.chain(e, e);
+  }
+  friend constexpr dual log(const dual& d)
+  {
+    using std::log;
+    return d.chain(log(d.value), T{1} / d.value);
+  }
+  friend constexpr dual sin(const dual& d)
+  {
+    using std::cos;
+    using std::sin;
+    return d.chain(sin(d.value), cos(d.value));
+  }
+  friend constexpr dual cos(const dual& d)
+  {
+    using std::cos;
+    using std::sin;
+    return d.chain(cos(d.value), -sin(d.value));
+  }
+  friend constexpr dual tan(const dual& d)
+  {
+    using std::tan;
+    const T t = tan(d.value);
+    return d.chain(t, T{1} + t * t);
+  }
+  // u^c: c u^(c - 1) du, without the log of u
+  friend constexpr dual pow(const dual& base, const T& exponent)
+  {
+    using std::pow;
+    const T p = pow(base.value, exponent - T{1});
+    return base.chain(p * base.value, exponent * p);
+  }
+  friend constexpr dual pow(const T& base, const dual& exponent)
+  {
+    using std::log;
+    using std::pow;
+    const T p = pow(base, exponent.value);
+    return exponent.chain(p, p * log(base));
+  }
+  // u^v: v u^(v - 1) du + u^v log(u) dv
+  friend constexpr dual pow(const dual& base, const dual& exponent)
+  {
+    using std::log;
+    using std::pow;
+    const T p = pow(base.value, exponent.value - T{1});
+    const T value = p * base.value;
+    const T du = exponent.value * p;
+    const T dv = value * log(base.value);
+    dual result{value};
+    for (std::size_t i = 0; i < N; ++i)
+      result.tangent[i] = du * base.tangent[i] + dv * exponent.tangent[i];
+    return result;
+  }
+};
+
+// An input: value, with tangent 1 along direction and 0 along the others
+template<std::size_t N, typename T>
+constexpr dual<T, N> seed_dual(const T& value, std::size_t direction)
+{
+  dual<T, N> d{value};
+  d.tangent[direction] = T{1};
+  return d;
+}
+
+// Opt in: a dual folds through the simplifier like a builtin number
+template<typename T, std::size_t N>
+struct is_numeric_value<dual<T, N>> : std::true_type
+{};
+
+/*
+ *  Jacobian-Vector Products
+ *  jvp(compile(expr, x, y), point, direction) evaluates expr at point and its
+ *  derivative along direction in one call, on dual<T, 1> inputs.
+ */
+
+template<typename Expression, typename... Symbols, typename T, std::size_t N>
+  requires(N == sizeof...(Symbols))
+constexpr auto jvp(const compiled_formula<Expression, Symbols...>& kernel, const std::array<T, N>& point,
+                   const std::array<T, N>& direction)
+{
+  return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+    return kernel(dual<T, 1>{point[Is], {direction[Is]}}...);
+  }(std::make_index_sequence<N>{});
+}
+
+/*
+ *  Colored Jacobians
+ *  colored_jacobian(compile(bundle, x, y, z), point, values) evaluates the
+ *  Jacobian of the bundle's outputs with respect to every symbol of the
+ *  kernel in one call on dual<T, color_count> inputs, the inputs of a color
+ *  seeded along the same tangent (see jacobian_sparsity). values receives the
+ *  nonzeros in CSR order, sparsity_pattern(bundle, x, y, z).column_indices
+ *  giving their columns; the outputs themselves are returned.
+ */
+
+template<typename... Outputs, typename... Symbols, typename T, std::size_t N, std::size_t Extent>
+  requires(N == sizeof...(Symbols))
+constexpr auto colored_jacobian(const compiled_bundle<formula_bundle<Outputs...>, Symbols...>& kernel,
+                                const std::array<T, N>& point, std::span<T, Extent> values)
+{
+  using sparsity = jacobian_sparsity<std::tuple<Symbols...>, Outputs...>;
+  static_assert(Extent == std::dynamic_extent || Extent >= sparsity::nonzeros,
+                "colored_jacobian: values holds fewer elements than nonzeros");
+  using seeded = dual<T, std::max(sparsity::color_count, std::size_t{1})>;
+  const auto results = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+    return kernel(seed_dual<seeded::tangents>(point[Is], sparsity::colors[Is])...);
+  }(std::make_index_sequence<N>{});
+
+  std::array<T, sizeof...(Outputs)> outputs{};
+  [&]<std::size_t... Rs>(std::index_sequence<Rs...>) {
+    (
+      [&]<std::size_t R>(std::integral_constant<std::size_t, R>) {
+        const auto& result = std::get<R>(results);
+        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(result)>, seeded>)
+        {
+          outputs[R] = result.value;
+          for (std::size_t k = sparsity::row_offsets[R]; k < sparsity::row_offsets[R + 1]; ++k)
+            values[k] = result.tangent[sparsity::colors[sparsity::column_indices[k]]];
+        }
+        else
+          // free of every symbol: the row is empty
+          outputs[R] = static_cast<T>(result);
+      }(std::integral_constant<std::size_t, Rs>{}),
+      ...);
+  }(std::index_sequence_for<Outputs...>{});
+  return outputs;
+}
+
+} // end namespace lam::symbols
@@ -19,6 +19,7 @@ import std;
 export module lam.symbols:engine;
 import :traits;
 import :core;
+import :chains;
 
 export namespace lam::symbols
 {
@@ -41,6 +42,9 @@ struct is_symbolic_expression<symbolic_expression<Op, Terms...>> : std::true_typ
 template<typename T>
 concept symbolic_or_arithmetic = symbolic<T> || std::is_arithmetic_v<T>;
 
+template<typename T>
+concept symbolic_or_numeric = symbolic<T> || numeric_value<T>;
+
 template<symbolic Expression>
 struct formula
 {
@@ -74,6 +78,161 @@ constexpr auto evaluate_term(const Term& term, const Substitution& s)
     return term;
 }
 
+/*
+ *  Numeric Folding
+ *  Used by every simplify_* function once both operands are numeric values.
+ *  A pair without a mixed operator (int * std::complex<double>) is folded by
+ *  converting one operand to the other operand's type.
+ */
+
+template<typename T, typename U>
+constexpr bool are_numeric_values_v = is_numeric_value_v<T> && is_numeric_value_v<U>;
+
+template<typename Op, typename Lhs, typename Rhs>
+constexpr auto fold_numeric(const Op& op, const Lhs& lhs, const Rhs& rhs)
+{
+  if constexpr (std::is_invocable_v<const Op&, const Lhs&, const Rhs&>)
+    return op(lhs, rhs);
+  else if constexpr (std::is_constructible_v<Rhs, const Lhs&>)
+    return op(static_cast<Rhs>(lhs), rhs);
+  else
+    return op(lhs, static_cast<Lhs>(rhs));
+}
+
+// pow, sqrt and cbrt found by argument dependent lookup, std:: for builtin types
+namespace numeric_detail
+{
+using std::cbrt;
+using std::pow;
+using std::sqrt;
+struct pow_fn
+{
+  template<typename Base, typename Exp>
+  constexpr auto operator()(const Base& base, const Exp& exp) const -> decltype(pow(base, exp))
+  { return pow(base, exp); }
+};
+struct sqrt_fn
+{
+  template<typename T>
+  constexpr auto operator()(const T& x) const -> decltype(sqrt(x))
+  { return sqrt(x); }
+};
+struct cbrt_fn
+{
+  template<typename T>
+  constexpr auto operator()(const T& x) const -> decltype(cbrt(x))
+  { return cbrt(x); }
+};
+} // namespace numeric_detail
+
+/*
+ *  Constant Exponents
+ *  x^c with c a constant_symbol never reaches pow when c is an integer, a half
+ *  or an exact third: integers are the multiplications of an addition chain,
+ *  halves and thirds add one sqrt or cbrt, and a negative exponent one
+ *  reciprocal. Unlike pow, cbrt is defined for negative bases, so only a
+ *  rational exponent, c<rational{2, 3}>, opts into it; a floating exponent
+ *  such as 1.0 / 3.0 is not exactly a third and keeps the NaN of pow.
+ */
+
+// c = numerator / denominator; denominator 0 when c is none of the lowered forms
+struct exponent_fraction
+{
+  long long numerator;
+  long long denominator;
+};
+
+inline constexpr long long max_lowered_exponent = 1 << 16;
+
+template<auto C>
+constexpr exponent_fraction constant_exponent = [] {
+  using T = decltype(C);
+  if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>)
+  {
+    if (std::cmp_greater_equal(C, -max_lowered_exponent) && std::cmp_less_equal(C, max_lowered_exponent))
+      return exponent_fraction{static_cast<long long>(C), 1};
+  }
+  else if constexpr (std::is_floating_point_v<T>)
+  {
+    for (long long denominator : {1, 2})
+    {
+      const T scaled = C * static_cast<T>(denominator);
+      if (scaled >= -max_lowered_exponent && scaled <= max_lowered_exponent &&
+          static_cast<T>(static_cast<long long>(scaled)) == scaled && scaled / static_cast<T>(denominator) == C)
+        return exponent_fraction{static_cast<long long>(scaled), denominator};
+    }
+  }
+  else if constexpr (is_rational_v<T>)
+  {
+    if (C.den <= 3 && C.num >= -max_lowered_exponent * C.den && C.num <= max_lowered_exponent * C.den)
+      return exponent_fraction{C.num, C.den};
+  }
+  return exponent_fraction{0, 0};
+}();
+
+template<auto C, typename T>
+constexpr bool is_lowered_exponent_v = [] {
+  constexpr exponent_fraction e = constant_exponent<C>;
+  if constexpr (e.denominator == 2)
+    return std::is_invocable_v<numeric_detail::sqrt_fn, const T&>;
+  else if constexpr (e.denominator == 3)
+    return std::is_invocable_v<numeric_detail::cbrt_fn, const T&>;
+  else
+    return e.denominator == 1;
+}();
+
+// x^(Roots / Denominator), Roots < Denominator
+template<long long Denominator, long long Roots, typename T>
+constexpr T root_power(const T& x)
+{
+  if constexpr (Denominator == 2)
+    return numeric_detail::sqrt_fn{}(x);
+  else
+  {
+    const T root = numeric_detail::cbrt_fn{}(x);
+    if constexpr (Roots == 2)
+      return root * root;
+    else
+      return root;
+  }
+}
+
+// base^C; Sequence is the power_sequence holding the integer part of |C|
+template<auto C, typename Sequence = void, typename Base>
+constexpr auto pow_by_constant(const Base& base)
+{
+  // integers promote to double, like std::pow
+  using T = std::conditional_t<std::is_integral_v<Base>, double, Base>;
+  if constexpr (!is_lowered_exponent_v<C, T> && is_rational_v<decltype(C)>)
+    return fold_numeric(numeric_detail::pow_fn{}, base, static_cast<rational_value_t<Base>>(C));
+  else if constexpr (!is_lowered_exponent_v<C, T>)
+    return fold_numeric(numeric_detail::pow_fn{}, base, C);
+  else
+  {
+    constexpr exponent_fraction e = constant_exponent<C>;
+    constexpr long long magnitude = e.numerator < 0 ? -e.numerator : e.numerator;
+    constexpr auto whole = static_cast<std::size_t>(magnitude / e.denominator);
+    constexpr long long roots = magnitude % e.denominator;
+    using sequence = std::conditional_t<std::is_void_v<Sequence>, power_sequence<whole>, Sequence>;
+
+    const T x = static_cast<T>(base);
+    const T value = [&] {
+      if constexpr (magnitude == 0)
+        return T{1};
+      else if constexpr (roots == 0)
+        return sequence::template power<whole>(x);
+      else if constexpr (whole == 0)
+        return root_power<e.denominator, roots>(x);
+      else
+        return T(sequence::template power<whole>(x) * root_power<e.denominator, roots>(x));
+    }();
+    if constexpr (e.numerator < 0)
+      return T(T{1} / value);
+    else
+      return value;
+  }
+}
+
 
 /*
  *  Simplification
@@ -87,6 +246,60 @@ constexpr auto simplify_expression(const Operator& op, Lhs&& lhs, Rhs&& rhs);
 template<typename Operator, typename Arg>
 constexpr auto simplify_expression(const Operator& op, Arg&& arg);
 
+// Power simplification forward declaration
+template<typename Base, typename Exp>
+constexpr auto simplify_pow(Base&& base, Exp&& exp);
+
+// Forward declaration of power operator (defined later)
+template<typename T>
+struct power;
+
+// Trait: power node whose exponent is a constant_symbol
+template<typename T>
+struct has_constant_exponent : std::false_type
+{};
+template<typename Base, auto C>
+struct has_constant_exponent<symbolic_expression<power<void>, Base, constant_symbol<C>>> : std::true_type
+{};
+
+
+// Trait: operators that take every operand at once, Op{}(v0, v1, ..., vn).
+// Other operators are folded left to right through simplify_expression.
+template<typename Operator>
+struct is_nary_operator : std::false_type
+{};
+template<typename Operator>
+constexpr bool is_nary_operator_v = is_nary_operator<std::remove_cvref_t<Operator>>::value;
+
+// Trait: T holds at least one symbol
+template<typename T>
+struct has_symbols : std::false_type
+{};
+template<class Trait, auto Id>
+struct has_symbols<symbol<Trait, Id>> : std::true_type
+{};
+template<typename Op, typename... Terms>
+struct has_symbols<symbolic_expression<Op, Terms...>>
+  : std::bool_constant<(has_symbols<std::remove_cvref_t<Terms>>::value || ...)>
+{};
+
+// Trait: Substitution binds at least one symbol of T
+template<typename Substitution, typename T>
+struct binds_symbol_of : std::false_type
+{};
+template<typename... Binders, class Trait, auto Id>
+struct binds_symbol_of<substitution<Binders...>, symbol<Trait, Id>>
+  : std::bool_constant<(std::is_same_v<typename std::remove_reference_t<Binders>::symbol_type, symbol<Trait, Id>> ||
+                        ...)>
+{};
+template<typename... Symbols, typename... Values, class Trait, auto Id>
+struct binds_symbol_of<positional_substitution<std::tuple<Symbols...>, Values...>, symbol<Trait, Id>>
+  : std::bool_constant<(std::is_same_v<Symbols, symbol<Trait, Id>> || ...)>
+{};
+template<typename Substitution, typename Op, typename... Terms>
+struct binds_symbol_of<Substitution, symbolic_expression<Op, Terms...>>
+  : std::bool_constant<(binds_symbol_of<Substitution, std::remove_cvref_t<Terms>>::value || ...)>
+{};
 
 // The class for symbolic expressions
 template<typename Operator, typename... Terms>
@@ -119,10 +332,19 @@ struct symbolic_expression
     }
   }
 
-  template<class... Binders>
-  constexpr auto operator()(const substitution<Binders...>& s) const noexcept
+  template<substitution_like Substitution>
+  constexpr auto operator()(const Substitution& s) const noexcept
   {
-    if constexpr (sizeof...(Terms) == 1)
+    // Partial substitution: a subtree binding none of its symbols is kept as
+    // it is, constant_symbols included, and only bound subtrees are folded
+    if constexpr (has_symbols<symbolic_expression>::value && !binds_symbol_of<Substitution, symbolic_expression>::value)
+      return *this;
+    else if constexpr (is_nary_operator_v<Operator>)
+      return std::apply([&](const auto&... term) { return Operator{}(evaluate_term(term, s)...); }, terms);
+    else if constexpr (has_constant_exponent<symbolic_expression>::value)
+      // the exponent stays a constant_symbol, for simplify_pow to lower
+      return simplify_pow(evaluate_term(std::get<0>(terms), s), std::get<1>(terms));
+    else if constexpr (sizeof...(Terms) == 1)
     {
        return simplify_expression(Operator{}, evaluate_term(std::get<0>(terms), s));
     }
@@ -208,10 +430,6 @@ constexpr bool are_same_symbolic_value_v =
  *  These enable compile-time pattern matching on symbolic expression structure
  */
 
-// Forward declaration of power operator (defined later)
-template<typename T>
-struct power;
-
 // Extract operator from a symbolic_expression
 template<typename T>
 struct expression_operator
@@ -263,6 +481,17 @@ constexpr bool is_power_expr_v = is_expr_with_op<std::remove_cvref_t<T>, power<v
 template<typename T>
 constexpr bool is_negate_expr_v = is_expr_with_op<std::remove_cvref_t<T>, std::negate<void>>::value;
 
+// Trait: Symbol appears somewhere in T
+template<typename T, typename Symbol>
+struct contains_symbol : std::is_same<T, Symbol>
+{};
+template<typename Op, typename... Terms, typename Symbol>
+struct contains_symbol<symbolic_expression<Op, Terms...>, Symbol>
+  : std::bool_constant<(contains_symbol<Terms, Symbol>::value || ...)>
+{};
+template<typename T, typename Symbol>
+constexpr bool contains_symbol_v = contains_symbol<std::remove_cvref_t<T>, std::remove_cvref_t<Symbol>>::value;
+
 // Unified Structural Accessors
 template<typename T>
 struct get_lhs
@@ -335,6 +564,8 @@ template<typename Lhs, typename Rhs>
 constexpr auto simplify_add(Lhs&& lhs, Rhs&& rhs);
 template<typename Lhs, typename Rhs>
 constexpr auto simplify_mul(Lhs&& lhs, Rhs&& rhs);
+template<typename Lhs, typename Rhs>
+constexpr auto simplify_sub(Lhs&& lhs, Rhs&& rhs);
 
 // Trait: Check if type is constant_symbol<V>
 template<typename T>
@@ -346,6 +577,96 @@ struct is_constant_symbol<constant_symbol<V>> : std::true_type
 template<typename T>
 constexpr bool is_constant_symbol_v = is_constant_symbol<std::remove_cvref_t<T>>::value;
 
+// Trait: a constant_symbol meeting a numeric value, the two fold to a value
+template<typename T, typename U>
+constexpr bool are_mixed_constant_values_v =
+  (is_constant_symbol_v<T> && is_numeric_value_v<U>) || (is_numeric_value_v<T> && is_constant_symbol_v<U>);
+
+// Trait: numeric value or constant_symbol, a bound leaf of a partial substitution
+template<typename T>
+constexpr bool is_foldable_value_v = is_numeric_value_v<T> || is_constant_symbol_v<T>;
+
+// The value a numeric value or constant_symbol folds with beside an Other,
+// a rational converted to the type of a numeric Other
+template<typename Other, typename T>
+constexpr auto folding_value(const T& t)
+{
+  if constexpr (is_constant_symbol_v<T>)
+    return std::remove_cvref_t<T>::template evaluated<Other>();
+  else
+    return t;
+}
+
+// Folds two foldable values, at least one of them numeric
+template<typename Op, typename Lhs, typename Rhs>
+constexpr auto fold_values(const Op& op, const Lhs& lhs, const Rhs& rhs)
+{ return fold_numeric(op, folding_value<Rhs>(lhs), folding_value<Lhs>(rhs)); }
+
+/*
+ *  Constant Folding
+ *  Two constant_symbols fold to one holding op(L, R). Integers and rationals
+ *  fold exactly, a quotient of integers included, c<1> / c<3> being
+ *  c<rational{1, 3}>; with a floating constant the result is floating. A
+ *  result that is an integer is an int constant_symbol, so that
+ *  c<rational{1, 2}> + c<rational{1, 2}>, or c<0.5> * c<2>, is the structural
+ *  one and leaves the product. A fold that overflows does not compile.
+ */
+
+// constant_symbol<V>, with V an int when it is one
+template<auto V>
+constexpr auto normalized_constant()
+{
+  using T = decltype(V);
+  if constexpr (is_rational_v<T>)
+  {
+    if constexpr (V.den == 1 && std::in_range<int>(V.num))
+      return constant_symbol<static_cast<int>(V.num)>{};
+    else
+      return constant_symbol<V>{};
+  }
+  else if constexpr (std::is_floating_point_v<T>)
+  {
+    if constexpr (V >= std::numeric_limits<int>::min() && V <= std::numeric_limits<int>::max() &&
+                  V == static_cast<T>(static_cast<int>(V)))
+      return constant_symbol<static_cast<int>(V)>{};
+    else
+      return constant_symbol<V>{};
+  }
+  else
+    return constant_symbol<V>{};
+}
+
+template<auto V>
+constexpr bool is_integer_constant_v = std::is_integral_v<decltype(V)> && !std::is_same_v<decltype(V), bool>;
+
+// Trait: c<L> / c<R> folds, R not zero
+template<typename Lhs, typename Rhs>
+constexpr bool is_foldable_quotient_v = [] {
+  if constexpr (is_constant_symbol_v<Lhs> && is_constant_symbol_v<Rhs>)
+    return std::remove_cvref_t<Rhs>::value != 0;
+  else
+    return false;
+}();
+
+template<typename Op, auto L, auto R>
+constexpr auto fold_constants(const Op&, constant_symbol<L>, constant_symbol<R>)
+{
+  if constexpr (std::is_same_v<Op, std::divides<void>> && is_integer_constant_v<L> && is_integer_constant_v<R>)
+    return normalized_constant<rational(L, R)>();
+  else
+    return normalized_constant<Op{}(L, R)>();
+}
+
+// Trait: Check if type is a (variable) symbol
+template<typename T>
+struct is_symbol : std::false_type
+{};
+template<class Trait, auto Id>
+struct is_symbol<symbol<Trait, Id>> : std::true_type
+{};
+template<typename T>
+constexpr bool is_symbol_v = is_symbol<std::remove_cvref_t<T>>::value;
+
 // Term Analysis Traits
 template<typename T>
 struct term_traits
@@ -364,7 +685,7 @@ template<typename... Args>
 struct term_traits<symbolic_expression<std::multiplies<void>, Args...>>
 {
   using Expr = symbolic_expression<std::multiplies<void>, Args...>;
-  static constexpr bool first_is_const = is_constant_symbol_v<std::tuple_element_t<0, std::tuple<Args...>>>;
+  static constexpr bool first_is_const = is_foldable_value_v<std::tuple_element_t<0, std::tuple<Args...>>>;
 
   static constexpr auto get_coeff(const Expr& expr)
   {
@@ -380,13 +701,237 @@ struct term_traits<symbolic_expression<std::multiplies<void>, Args...>>
       if constexpr (sizeof...(Args) == 2)
         return std::get<1>(expr.terms);
       else
-        return expr;
+        // the product without its coefficient, so k1 * x * y and k2 * x * y are like terms
+        return std::apply(
+          [](const auto&, const auto&... rest) {
+            return symbolic_expression<std::multiplies<void>, std::remove_cvref_t<decltype(rest)>...>(rest...);
+          },
+          expr.terms);
     }
     else
       return expr;
   }
 };
 
+/*
+ *  Value-Aware Merging
+ *  are_same_symbolic_value_v only holds for stateless types, so k1 * x and
+ *  k2 * x stop merging once k1 or k2 is a runtime value, e.g. after a partial
+ *  substitution. Like terms whose coefficients hold the values still merge
+ *  when the merge is coefficient arithmetic: the merged type is the same
+ *  whatever the values, and the result is exact for all of them. Two equal
+ *  values of one type cannot choose a result type at construction, so a
+ *  merge that only holds for equal values, sin(k * x) - sin(k * x), stays.
+ *  For the same reason a cancellation keeps its node: 2.0 * x - 2.0 * x is a
+ *  stored 0.0 * x, and each evaluation still multiplies by the zero. Skipping
+ *  the multiply would take a branch on the value, and would turn the NaN of
+ *  0.0 * inf into 0.0; bind the coefficient as a constant_symbol to cancel
+ *  the term at compile time. Stateless operands take the compile-time path,
+ *  unchanged.
+ */
+
+template<typename T>
+using term_base_t = std::remove_cvref_t<decltype(term_traits<std::remove_cvref_t<T>>::get_base(
+  std::declval<const std::remove_cvref_t<T>&>()))>;
+
+// Trait: k1 * A and k2 * A, A stateless, at least one of k1, k2 a runtime value
+template<typename T, typename U>
+constexpr bool are_value_like_terms_v = [] {
+  if constexpr (is_foldable_value_v<T> || is_foldable_value_v<U> || (is_stateless_v<T> && is_stateless_v<U>))
+    return false;
+  else
+    return are_same_symbolic_value_v<term_base_t<T>, term_base_t<U>>;
+}();
+
+// A factor of a product as base^exponent, so like factors add their exponents
+template<typename T>
+struct factor_traits
+{
+  static constexpr auto get_exponent(const T&) { return constant_symbol<1>{}; }
+  static constexpr const T& get_base(const T& t) { return t; }
+};
+template<typename Base, typename Exp>
+struct factor_traits<symbolic_expression<power<void>, Base, Exp>>
+{
+  using Expr = symbolic_expression<power<void>, Base, Exp>;
+  static constexpr auto get_exponent(const Expr& expr) { return std::get<1>(expr.terms); }
+  static constexpr auto get_base(const Expr& expr) { return std::get<0>(expr.terms); }
+};
+// 1 / x is x^-1
+template<typename Base>
+struct factor_traits<symbolic_expression<std::divides<void>, constant_symbol<1>, Base>>
+{
+  using Expr = symbolic_expression<std::divides<void>, constant_symbol<1>, Base>;
+  static constexpr auto get_exponent(const Expr&) { return constant_symbol<-1>{}; }
+  static constexpr auto get_base(const Expr& expr) { return std::get<1>(expr.terms); }
+};
+
+/*
+ *  Canonical Order
+ *  Flattened sums and products keep their operands sorted, so that x + y and
+ *  y + x, or a * b * c and c * a * b, are one type: the patterns matching
+ *  equal operands see more equalities, (x + y) - (y + x) cancels, and every
+ *  permutation shares one instantiation. The order is a constant expression
+ *  over types: constant_symbols first, by value, then other values, symbols,
+ *  and expressions, by operator, arity and operands in turn. The terms of a
+ *  sum are ordered by their base first, without the leading coefficient, and
+ *  the factors of a product by the base of a power, so that like terms and
+ *  like factors are adjacent. The order only uses what every translation
+ *  unit agrees on: a symbol is placed by the order of its tag,
+ *  ordered_symbol<N> or symbol_id<Tag> with a Tag::order of its own, and the
+ *  built-in operators by a fixed rank. Two operands without such a key tie
+ *  and keep the order they were combined in, so x + y and y + x, x and y
+ *  plain symbols, stay two types.
+ */
+
+// Trait: the symbol's tag gives it a place in the order
+template<typename T>
+constexpr bool has_symbol_order_v = [] {
+  if constexpr (requires { std::remove_cvref_t<decltype(T::id)>::tag_type::order; })
+    return std::is_integral_v<std::remove_cvref_t<decltype(std::remove_cvref_t<decltype(T::id)>::tag_type::order)>>;
+  else
+    return false;
+}();
+
+template<typename T>
+constexpr std::size_t symbol_order_v = std::remove_cvref_t<decltype(T::id)>::tag_type::order;
+
+// Rank of the built-in operators; 0 for any other
+template<typename Op>
+constexpr int operator_rank = 0;
+template<>
+constexpr int operator_rank<std::plus<void>> = 1;
+template<>
+constexpr int operator_rank<std::minus<void>> = 2;
+template<>
+constexpr int operator_rank<std::multiplies<void>> = 3;
+template<>
+constexpr int operator_rank<std::divides<void>> = 4;
+template<>
+constexpr int operator_rank<std::negate<void>> = 5;
+template<>
+constexpr int operator_rank<power<void>> = 6;
+
+template<typename T>
+constexpr int order_rank = is_constant_symbol_v<T> ? 0 : !is_symbolic_v<T> ? 1 : is_symbol_v<T> ? 2 : 3;
+
+// -1, 0 or 1 as T goes before, ties with or goes after U
+template<typename T, typename U>
+struct canonical_order
+{
+  static constexpr int value = [] {
+    if constexpr (std::is_same_v<T, U>)
+      return 0;
+    else if constexpr (order_rank<T> != order_rank<U>)
+      return order_rank<T> < order_rank<U> ? -1 : 1;
+    else if constexpr (is_constant_symbol_v<T>)
+    {
+      if constexpr (requires { T::value < U::value; })
+        return T::value < U::value ? -1 : U::value < T::value ? 1 : 0;
+      else
+        return 0;
+    }
+    else if constexpr (is_symbol_v<T> && has_symbol_order_v<T> && has_symbol_order_v<U>)
+      return symbol_order_v<T> < symbol_order_v<U> ? -1 : symbol_order_v<U> < symbol_order_v<T> ? 1 : 0;
+    else
+      return 0;
+  }();
+};
+template<typename LhsOp, typename... Lhs, typename RhsOp, typename... Rhs>
+struct canonical_order<symbolic_expression<LhsOp, Lhs...>, symbolic_expression<RhsOp, Rhs...>>
+{
+  static constexpr int value = [] {
+    if constexpr (!std::is_same_v<LhsOp, RhsOp>)
+    {
+      if constexpr (operator_rank<LhsOp> != 0 && operator_rank<RhsOp> != 0)
+        return operator_rank<LhsOp> < operator_rank<RhsOp> ? -1 : 1;
+      else
+        return 0;
+    }
+    else if constexpr (sizeof...(Lhs) != sizeof...(Rhs))
+      return sizeof...(Lhs) < sizeof...(Rhs) ? -1 : 1;
+    else
+    {
+      int result = 0;
+      ((result = result != 0 ? result : canonical_order<Lhs, Rhs>::value), ...);
+      return result;
+    }
+  }();
+};
+
+// What an operand of Op is ordered by first
+template<typename Op, typename T>
+struct order_base
+{ using type = T; };
+template<typename Coefficient, typename... Rest>
+  requires(is_foldable_value_v<Coefficient> && sizeof...(Rest) > 0)
+struct order_base<std::plus<void>, symbolic_expression<std::multiplies<void>, Coefficient, Rest...>>
+{
+  using type =
+    std::conditional_t<sizeof...(Rest) == 1, std::tuple_element_t<0, std::tuple<Rest..., void>>,
+                       symbolic_expression<std::multiplies<void>, Rest...>>;
+};
+template<typename Base, typename Exp>
+struct order_base<std::multiplies<void>, symbolic_expression<power<void>, Base, Exp>>
+{ using type = Base; };
+
+template<typename Op, typename T, typename U>
+constexpr bool canonical_before_v = [] {
+  constexpr int by_base = canonical_order<typename order_base<Op, T>::type, typename order_base<Op, U>::type>::value;
+  if constexpr (by_base != 0)
+    return by_base < 0;
+  else
+    return canonical_order<T, U>::value < 0;
+}();
+
+// term inserted into sorted operands, after every operand it does not go before
+template<typename Op, typename Tuple, typename Term>
+constexpr auto insert_sorted(Tuple&& tuple, Term&& term)
+{
+  using tuple_t = std::remove_cvref_t<Tuple>;
+  using term_t = std::remove_cvref_t<Term>;
+  constexpr std::size_t size = std::tuple_size_v<tuple_t>;
+  constexpr std::size_t position = []<std::size_t... Is>(std::index_sequence<Is...>) {
+    std::size_t p = size;
+    ((p = (p == size && canonical_before_v<Op, term_t, std::tuple_element_t<Is, tuple_t>>) ? Is : p), ...);
+    return p;
+  }(std::make_index_sequence<size>{});
+  return [&]<std::size_t... Before, std::size_t... After>(std::index_sequence<Before...>,
+                                                           std::index_sequence<After...>) {
+    return std::tuple<std::tuple_element_t<Before, tuple_t>..., term_t,
+                      std::tuple_element_t<position + After, tuple_t>...>(
+      std::get<Before>(std::forward<Tuple>(tuple))..., std::forward<Term>(term),
+      std::get<position + After>(std::forward<Tuple>(tuple))...);
+  }(std::make_index_sequence<position>{}, std::make_index_sequence<size - position>{});
+}
+
+// The operands of terms inserted one by one into sorted
+template<typename Op, typename Sorted, typename Terms>
+constexpr auto insert_all_sorted(Sorted&& sorted, Terms&& terms)
+{
+  if constexpr (std::tuple_size_v<std::remove_cvref_t<Terms>> == 0)
+    return std::forward<Sorted>(sorted);
+  else
+    return std::apply(
+      [&](auto&& first, auto&&... rest) {
+        return insert_all_sorted<Op>(insert_sorted<Op>(std::forward<Sorted>(sorted), std::forward<decltype(first)>(first)),
+                                     std::make_tuple(std::forward<decltype(rest)>(rest)...));
+      },
+      std::forward<Terms>(terms));
+}
+
+// Binary Op node, operands in canonical order
+template<typename Op, typename Lhs, typename Rhs>
+constexpr auto make_ordered_expression(Lhs&& lhs, Rhs&& rhs)
+{
+  using lhs_t = std::remove_cvref_t<Lhs>;
+  using rhs_t = std::remove_cvref_t<Rhs>;
+  if constexpr (canonical_before_v<Op, rhs_t, lhs_t>)
+    return symbolic_expression<Op, rhs_t, lhs_t>(std::forward<Rhs>(rhs), std::forward<Lhs>(lhs));
+  else
+    return symbolic_expression<Op, lhs_t, rhs_t>(std::forward<Lhs>(lhs), std::forward<Rhs>(rhs));
+}
+
 // Tuple Helpers
 template<std::size_t I, std::size_t SkipIndex>
 struct remove_helper
@@ -435,7 +980,7 @@ template<std::size_t I = 0, typename Tuple, typename Term>
 constexpr auto merge_term_into_tuple(Tuple&& tuple, Term&& term)
 {
   if constexpr (I >= std::tuple_size_v<std::remove_cvref_t<Tuple>>)
-    return std::tuple_cat(std::forward<Tuple>(tuple), std::make_tuple(std::forward<Term>(term)));
+    return insert_sorted<std::plus<void>>(std::forward<Tuple>(tuple), std::forward<Term>(term));
   else
   {
     auto& current = std::get<I>(tuple);
@@ -445,7 +990,12 @@ constexpr auto merge_term_into_tuple(Tuple&& tuple, Term&& term)
     auto base1 = CurrTraits::get_base(current);
     auto base2 = TermTraits::get_base(term);
 
-    if constexpr (are_same_symbolic_value_v<decltype(base1), decltype(base2)>)
+    // Bound values and constants fold into one value
+    if constexpr (are_numeric_values_v<decltype(current), Term> ||
+                  are_mixed_constant_values_v<decltype(current), Term>)
+      return tuple_replace_impl<Tuple, I>(std::forward<Tuple>(tuple), fold_values(std::plus<void>{}, current, term),
+                                          std::make_index_sequence<std::tuple_size_v<std::remove_cvref_t<Tuple>>>{});
+    else if constexpr (are_same_symbolic_value_v<decltype(base1), decltype(base2)>)
     {
       auto new_coeff = simplify_add(CurrTraits::get_coeff(current), TermTraits::get_coeff(term));
 
@@ -464,6 +1014,103 @@ constexpr auto merge_term_into_tuple(Tuple&& tuple, Term&& term)
   }
 }
 
+// Recursive Merge for products: constant_symbols fold into the leading
+// coefficient, like factors into one power, and a factor meeting its
+// reciprocal leaves the product
+template<std::size_t I = 0, typename Tuple, typename Factor>
+constexpr auto merge_factor_into_tuple(Tuple&& tuple, Factor&& factor)
+{
+  using tuple_t = std::remove_cvref_t<Tuple>;
+  using factor_t = std::remove_cvref_t<Factor>;
+  constexpr std::size_t size = std::tuple_size_v<tuple_t>;
+  if constexpr (is_structural_one_v<factor_t>)
+    return std::forward<Tuple>(tuple);
+  else if constexpr (size == 0)
+    return std::tuple<factor_t>(std::forward<Factor>(factor));
+  // Bound values and constants fold into one leading value
+  else if constexpr (is_foldable_value_v<factor_t> &&
+                     (are_numeric_values_v<std::tuple_element_t<0, tuple_t>, factor_t> ||
+                      are_mixed_constant_values_v<std::tuple_element_t<0, tuple_t>, factor_t>))
+    return tuple_replace_impl<Tuple, 0>(std::forward<Tuple>(tuple),
+                                        fold_values(std::multiplies<void>{}, std::get<0>(tuple), factor),
+                                        std::make_index_sequence<size>{});
+  else if constexpr (is_constant_symbol_v<factor_t>)
+  {
+    if constexpr (is_constant_symbol_v<std::tuple_element_t<0, tuple_t>>)
+    {
+      using coeff_t = decltype(simplify_mul(std::get<0>(tuple), factor));
+      if constexpr (is_structural_zero_v<coeff_t>)
+        return std::tuple<constant_symbol<0>>{};
+      else if constexpr (is_structural_one_v<coeff_t>)
+        return tuple_remove_impl<Tuple, 0>(std::forward<Tuple>(tuple), std::make_index_sequence<size>{});
+      else
+        return tuple_replace_impl<Tuple, 0>(std::forward<Tuple>(tuple), coeff_t{}, std::make_index_sequence<size>{});
+    }
+    else if constexpr (is_structural_zero_v<factor_t>)
+      return std::tuple<constant_symbol<0>>{};
+    else
+      return insert_sorted<std::multiplies<void>>(std::forward<Tuple>(tuple), std::forward<Factor>(factor));
+  }
+  else if constexpr (I >= size)
+    return insert_sorted<std::multiplies<void>>(std::forward<Tuple>(tuple), std::forward<Factor>(factor));
+  else
+  {
+    auto& current = std::get<I>(tuple);
+    using current_t = std::remove_cvref_t<decltype(current)>;
+    using CurrTraits = factor_traits<current_t>;
+    using FactorTraits = factor_traits<factor_t>;
+
+    if constexpr (!is_constant_symbol_v<current_t> &&
+                  are_same_symbolic_value_v<decltype(CurrTraits::get_base(current)),
+                                            decltype(FactorTraits::get_base(factor))>)
+    {
+      auto exponent = simplify_add(CurrTraits::get_exponent(current), FactorTraits::get_exponent(factor));
+
+      if constexpr (is_structural_zero_v<decltype(exponent)>)
+        return tuple_remove_impl<Tuple, I>(std::forward<Tuple>(tuple), std::make_index_sequence<size>{});
+      else
+        return tuple_replace_impl<Tuple, I>(std::forward<Tuple>(tuple),
+                                            simplify_pow(CurrTraits::get_base(current), std::move(exponent)),
+                                            std::make_index_sequence<size>{});
+    }
+    else
+      return merge_factor_into_tuple<I + 1>(std::forward<Tuple>(tuple), std::forward<Factor>(factor));
+  }
+}
+
+// The factors of factors merged one by one into merged
+template<typename Merged, typename Factors>
+constexpr auto merge_all_factors(Merged&& merged, Factors&& factors)
+{
+  if constexpr (std::tuple_size_v<std::remove_cvref_t<Factors>> == 0)
+    return std::forward<Merged>(merged);
+  else
+    return std::apply(
+      [&](auto&& first, auto&&... rest) {
+        return merge_all_factors(
+          merge_factor_into_tuple(std::forward<Merged>(merged), std::forward<decltype(first)>(first)),
+          std::make_tuple(std::forward<decltype(rest)>(rest)...));
+      },
+      std::forward<Factors>(factors));
+}
+
+// A product of the merged factors, 1 when none is left
+template<typename Tuple>
+constexpr auto make_product(Tuple&& factors)
+{
+  return std::apply(
+    [](auto&&... args) {
+      if constexpr (sizeof...(args) == 0)
+        return constant_symbol<1>{};
+      else if constexpr (sizeof...(args) == 1)
+        return std::get<0>(std::make_tuple(std::forward<decltype(args)>(args)...));
+      else
+        return symbolic_expression<std::multiplies<void>, std::remove_cvref_t<decltype(args)>...>(
+          std::forward<decltype(args)>(args)...);
+    },
+    std::forward<Tuple>(factors));
+}
+
 // Helper: merge_flat_expression (Replacement for append_flat)
 template<typename Op, typename Tuple1, typename Term>
 constexpr auto merge_flat_expression(Tuple1&& t1, Term&& term)
@@ -482,11 +1129,12 @@ constexpr auto merge_flat_expression(Tuple1&& t1, Term&& term)
       },
       std::move(merged_tuple));
   }
+  else if constexpr (std::is_same_v<Op, std::multiplies<void>>)
+    return make_product(merge_factor_into_tuple(std::forward<Tuple1>(t1), std::forward<Term>(term)));
   else
   {
-    // Fallback for Mul: Just append
-    auto t2 = std::make_tuple(std::forward<Term>(term));
-    auto combined = std::tuple_cat(std::forward<Tuple1>(t1), std::move(t2));
+    // Fallback: insert in order
+    auto combined = insert_sorted<Op>(std::forward<Tuple1>(t1), std::forward<Term>(term));
     return std::apply(
       [](auto&&... args) {
         return symbolic_expression<Op, std::remove_cvref_t<decltype(args)>...>(std::forward<decltype(args)>(args)...);
@@ -495,16 +1143,21 @@ constexpr auto merge_flat_expression(Tuple1&& t1, Term&& term)
   }
 }
 
-// Helper: make_flat_expression (Concatenate two tuples)
+// Helper: make_flat_expression (Merge two sorted tuples)
 template<typename Op, typename Tuple1, typename Tuple2>
 constexpr auto make_flat_expression(Tuple1&& t1, Tuple2&& t2)
 {
-  auto combined = std::tuple_cat(std::forward<Tuple1>(t1), std::forward<Tuple2>(t2));
-  return std::apply(
-    [](auto&&... args) {
-      return symbolic_expression<Op, std::remove_cvref_t<decltype(args)>...>(std::forward<decltype(args)>(args)...);
-    },
-    std::move(combined));
+  if constexpr (std::is_same_v<Op, std::multiplies<void>>)
+    return make_product(merge_all_factors(std::forward<Tuple1>(t1), std::forward<Tuple2>(t2)));
+  else
+  {
+    auto combined = insert_all_sorted<Op>(std::forward<Tuple1>(t1), std::forward<Tuple2>(t2));
+    return std::apply(
+      [](auto&&... args) {
+        return symbolic_expression<Op, std::remove_cvref_t<decltype(args)>...>(std::forward<decltype(args)>(args)...);
+      },
+      std::move(combined));
+  }
 }
 
 // Simplification for addition
@@ -525,21 +1178,35 @@ constexpr auto simplify_add(Lhs&& lhs, Rhs&& rhs)
   else if constexpr (is_structural_zero_v<Rhs>)
     return std::forward<Lhs>(lhs);
   else if constexpr (is_constant_symbol_v<Lhs> && is_constant_symbol_v<Rhs>)
-    return constant_symbol<std::remove_cvref_t<Lhs>::value + std::remove_cvref_t<Rhs>::value>{};
+    return fold_constants(std::plus<void>{}, lhs, rhs);
+  else if constexpr (are_mixed_constant_values_v<Lhs, Rhs>)
+    return fold_values(std::plus<void>{}, lhs, rhs);
   else if constexpr (are_same_symbolic_value_v<Lhs, Rhs>)
     // Pattern: x + x → 2 * x
     return constant_symbol<2>{} * std::forward<Lhs>(lhs);
   // Pattern: (A - B) + B → A
   else if constexpr (is_minus_expr_v<Lhs> && are_same_symbolic_value_v<expr_rhs_t<Lhs>, Rhs>)
-    return expr_lhs_t<Lhs>{};
+    return get_lhs_val(std::forward<Lhs>(lhs));
   // Pattern: B + (A - B) → A
   else if constexpr (is_minus_expr_v<Rhs> && are_same_symbolic_value_v<Lhs, expr_rhs_t<Rhs>>)
-    return expr_lhs_t<Rhs>{};
-  else if constexpr (std::is_arithmetic_v<std::remove_cvref_t<Lhs>> && std::is_arithmetic_v<std::remove_cvref_t<Rhs>>)
-    return lhs + rhs;
+    return get_lhs_val(std::forward<Rhs>(rhs));
+  else if constexpr (are_numeric_values_v<Lhs, Rhs>)
+    return fold_numeric(std::plus<void>{}, lhs, rhs);
+  // Pattern: k1 * A + k2 * A → (k1 + k2) * A, k1 or k2 a value
+  else if constexpr (are_value_like_terms_v<Lhs, Rhs>)
+    return merge_flat_expression<std::plus<void>>(std::make_tuple(std::forward<Lhs>(lhs)), std::forward<Rhs>(rhs));
   else
-    return symbolic_expression<std::plus<void>, std::remove_cvref_t<Lhs>, std::remove_cvref_t<Rhs>>(
-      std::forward<Lhs>(lhs), std::forward<Rhs>(rhs));
+    return make_ordered_expression<std::plus<void>>(std::forward<Lhs>(lhs), std::forward<Rhs>(rhs));
+}
+
+// lhs minus each term of a sum in turn, so every term meets its like term in lhs
+template<std::size_t I = 0, typename Lhs, typename Sum>
+constexpr auto subtract_terms(Lhs&& lhs, const Sum& sum)
+{
+  if constexpr (I >= std::tuple_size_v<decltype(sum.terms)>)
+    return std::forward<Lhs>(lhs);
+  else
+    return subtract_terms<I + 1>(simplify_sub(std::forward<Lhs>(lhs), std::get<I>(sum.terms)), sum);
 }
 
 // Simplification for subtraction (Normalize to Addition)
@@ -553,8 +1220,11 @@ constexpr auto simplify_sub(Lhs&& lhs, Rhs&& rhs)
   else if constexpr (is_structural_zero_v<Lhs>)
     // 0 - x -> -1 * x
     return simplify_mul(constant_symbol<-1>{}, std::forward<Rhs>(rhs));
-  else if constexpr (std::is_arithmetic_v<std::remove_cvref_t<Lhs>> && std::is_arithmetic_v<std::remove_cvref_t<Rhs>>)
-    return lhs - rhs;
+  else if constexpr (are_numeric_values_v<Lhs, Rhs> || are_mixed_constant_values_v<Lhs, Rhs>)
+    return fold_values(std::minus<void>{}, lhs, rhs);
+  // Pattern: A - (B + C) -> A - B - C, when values may cancel: (x + 1.0) - (x + 2.0) -> -1.0
+  else if constexpr (is_plus_expr_v<Rhs> && !(is_stateless_v<Lhs> && is_stateless_v<Rhs>))
+    return subtract_terms(std::forward<Lhs>(lhs), rhs);
   // Pattern: A - (A + B) -> -B
   else if constexpr (is_plus_expr_v<Rhs>)
   {
@@ -600,15 +1270,17 @@ constexpr auto simplify_mul(Lhs&& lhs, Rhs&& rhs)
   else if constexpr (is_structural_one_v<Rhs>)
     return std::forward<Lhs>(lhs);
   else if constexpr (is_constant_symbol_v<Lhs> && is_constant_symbol_v<Rhs>)
-    return constant_symbol<std::remove_cvref_t<Lhs>::value * std::remove_cvref_t<Rhs>::value>{};
+    return fold_constants(std::multiplies<void>{}, lhs, rhs);
+  else if constexpr (are_mixed_constant_values_v<Lhs, Rhs>)
+    return fold_values(std::multiplies<void>{}, lhs, rhs);
   // Flattening Logic
   else if constexpr (is_mul_expr_v<Lhs> && is_mul_expr_v<Rhs>)
     return make_flat_expression<std::multiplies<void>>(std::forward<Lhs>(lhs).terms, std::forward<Rhs>(rhs).terms);
   else if constexpr (is_mul_expr_v<Lhs>)
-    // Use merge_flat_expression for append (fallback logic handles it)
+    // Merge rhs into the factors of lhs, collecting like factors
     return merge_flat_expression<std::multiplies<void>>(std::forward<Lhs>(lhs).terms, std::forward<Rhs>(rhs));
   else if constexpr (is_mul_expr_v<Rhs>)
-    // Use make_flat_expression with temporary tuple for prepend
+    // Commutative merge: merge Lhs (as factor) into Rhs (tuple)
     return make_flat_expression<std::multiplies<void>>(std::make_tuple(std::forward<Lhs>(lhs)),
                                                        std::forward<Rhs>(rhs).terms);
   // Pattern: x^n * x^m → x^(n+m)
@@ -639,14 +1311,13 @@ constexpr auto simplify_mul(Lhs&& lhs, Rhs&& rhs)
       return symbolic_expression<std::multiplies<void>, std::remove_cvref_t<Lhs>, std::remove_cvref_t<Rhs>>(
         std::forward<Lhs>(lhs), std::forward<Rhs>(rhs));
   }
-  else if constexpr (std::is_arithmetic_v<std::remove_cvref_t<Lhs>> && std::is_arithmetic_v<std::remove_cvref_t<Rhs>>)
-    return lhs * rhs;
+  else if constexpr (are_numeric_values_v<Lhs, Rhs>)
+    return fold_numeric(std::multiplies<void>{}, lhs, rhs);
   // Pattern: ((... * Z) * ...) / Z → Remove Z deeply
   else if constexpr (is_mul_expr_v<Lhs> && is_deep_cancellation_v<get_lhs_t<Lhs>, Rhs, std::multiplies<void>>)
     return simplify_mul(simplify_div(get_lhs_val(std::forward<Lhs>(lhs)), rhs), get_rhs_val(std::forward<Lhs>(lhs)));
   else
-    return symbolic_expression<std::multiplies<void>, std::remove_cvref_t<Lhs>, std::remove_cvref_t<Rhs>>(
-      std::forward<Lhs>(lhs), std::forward<Rhs>(rhs));
+    return make_ordered_expression<std::multiplies<void>>(std::forward<Lhs>(lhs), std::forward<Rhs>(rhs));
 }
 
 // Simplification for division
@@ -657,17 +1328,24 @@ constexpr auto simplify_div(Lhs&& lhs, Rhs&& rhs)
     return std::forward<Lhs>(lhs);
   else if constexpr (are_same_symbolic_value_v<Lhs, Rhs>)
     return constant_symbol<1>{};
-  // Pattern: (A * B) / B → A
+  // Pattern: c1 / c2 → c, exact for integers and rationals
+  else if constexpr (is_foldable_quotient_v<Lhs, Rhs>)
+    return fold_constants(std::divides<void>{}, lhs, rhs);
+  // Pattern: (A * B) / B → A, A possibly a value
   else if constexpr (is_mul_expr_v<Lhs> && are_same_symbolic_value_v<expr_rhs_t<Lhs>, Rhs>)
-    return expr_lhs_t<Lhs>{};
+    return get_lhs_val(std::forward<Lhs>(lhs));
   // Pattern: (A * B) / A → B
   else if constexpr (is_mul_expr_v<Lhs> && are_same_symbolic_value_v<expr_lhs_t<Lhs>, Rhs>)
-    return expr_rhs_t<Lhs>{};
+    return get_rhs_val(std::forward<Lhs>(lhs));
+  // Pattern: (k1 * A) / (k2 * A) → k1 / k2, k1 or k2 a value
+  else if constexpr (are_value_like_terms_v<Lhs, Rhs>)
+    return fold_values(std::divides<void>{}, term_traits<std::remove_cvref_t<Lhs>>::get_coeff(lhs),
+                       term_traits<std::remove_cvref_t<Rhs>>::get_coeff(rhs));
   // Pattern: ((... * Z) * ...) / Z → Remove Z deeply
   else if constexpr (is_mul_expr_v<Lhs> && is_deep_cancellation_v<get_lhs_t<Lhs>, Rhs, std::multiplies<void>>)
     return simplify_mul(simplify_div(get_lhs_val(std::forward<Lhs>(lhs)), rhs), get_rhs_val(std::forward<Lhs>(lhs)));
-  else if constexpr (std::is_arithmetic_v<std::remove_cvref_t<Lhs>> && std::is_arithmetic_v<std::remove_cvref_t<Rhs>>)
-    return lhs / rhs;
+  else if constexpr (are_numeric_values_v<Lhs, Rhs> || are_mixed_constant_values_v<Lhs, Rhs>)
+    return fold_values(std::divides<void>{}, lhs, rhs);
   // Pattern: x^n / x → x^(n-1)
   else if constexpr (is_power_expr_v<Lhs> && are_same_symbolic_value_v<expr_lhs_t<Lhs>, Rhs>)
   {
@@ -710,8 +1388,11 @@ constexpr auto simplify_pow(Base&& base, Exp&& exp)
     return constant_symbol<0>{};
   else if constexpr (is_structural_one_v<Base>)
     return constant_symbol<1>{};
-  else if constexpr (std::is_arithmetic_v<std::remove_cvref_t<Base>> && std::is_arithmetic_v<std::remove_cvref_t<Exp>>)
-    return std::pow(base, exp);
+  // Pattern: value^c → multiplications (see pow_by_constant)
+  else if constexpr (is_numeric_value_v<Base> && is_constant_symbol_v<Exp>)
+    return pow_by_constant<std::remove_cvref_t<Exp>::value>(base);
+  else if constexpr (are_numeric_values_v<Base, Exp>)
+    return fold_numeric(numeric_detail::pow_fn{}, base, exp);
   // Pattern: (x^n)^m → x^(n*m)
   else if constexpr (is_power_expr_v<Base>)
   {
@@ -741,7 +1422,7 @@ constexpr auto simplify_neg(Arg&& arg)
   else if constexpr (is_minus_expr_v<Arg> && std::is_same_v<expr_lhs_t<std::remove_cvref_t<Arg>>, constant_symbol<0>>)
     // Pattern: -(-x) -> x (where -x is represented as 0 - x)
     return expr_rhs_t<std::remove_cvref_t<Arg>>{}; 
-  else if constexpr (std::is_arithmetic_v<std::remove_cvref_t<Arg>>)
+  else if constexpr (is_numeric_value_v<Arg>)
     return -arg;
   else
     return symbolic_expression<std::negate<void>, std::remove_cvref_t<Arg>>(std::forward<Arg>(arg));
@@ -762,8 +1443,8 @@ constexpr auto simplify_expression(const Operator& op, Lhs&& lhs, Rhs&& rhs)
   else
   {
     // Fallback for unhandled binary operators
-    if constexpr (std::is_arithmetic_v<std::remove_cvref_t<Lhs>> && std::is_arithmetic_v<std::remove_cvref_t<Rhs>>)
-      return op(std::forward<Lhs>(lhs), std::forward<Rhs>(rhs));
+    if constexpr (are_numeric_values_v<Lhs, Rhs>)
+      return fold_numeric(op, lhs, rhs);
     else
       return symbolic_expression<Operator, std::remove_cvref_t<Lhs>, std::remove_cvref_t<Rhs>>(std::forward<Lhs>(lhs),
                                                                                                std::forward<Rhs>(rhs));
@@ -779,13 +1460,97 @@ constexpr auto simplify_expression(const Operator& op, Arg&& arg)
   else
   {
     // Fallback for unhandled unary operators (like sin, cos, etc.)
-    if constexpr (std::is_arithmetic_v<std::remove_cvref_t<Arg>>)
+    if constexpr (is_numeric_value_v<Arg>)
       return op(std::forward<Arg>(arg));
     else
       return symbolic_expression<Operator, std::remove_cvref_t<Arg>>(std::forward<Arg>(arg));
   }
 }
+/*
+ *  Compilation (Positional Kernels)
+ *  compile(expr, x, y, z) fixes the symbol order once. The returned object is
+ *  called positionally, f(1.0, 2.0, 3.0), and evaluates against a
+ *  positional_substitution: no binder is built and every symbol lookup is a
+ *  compile-time index into a flat tuple of values.
+ */
+
+// Trait: Check that no type appears twice in a pack
+template<typename... Ts>
+constexpr bool are_distinct_types_v = true;
+template<typename T, typename... Rest>
+constexpr bool are_distinct_types_v<T, Rest...> = (!std::is_same_v<T, Rest> && ...) && are_distinct_types_v<Rest...>;
+
+namespace compile_detail
+{
+// T once per index, to expand a pack of indices into a pack of value types
+template<std::size_t, typename T>
+struct repeated_type
+{ using type = T; };
+} // namespace compile_detail
+
+template<symbolic Expression, typename... Symbols>
+  requires(is_symbol_v<Symbols> && ...)
+struct compiled_formula
+{
+  static_assert(are_distinct_types_v<Symbols...>, "compile: each symbol may only appear once");
+
+  using expression_type = Expression;
+  using symbols_type = std::tuple<Symbols...>;
+  static constexpr std::size_t arity = sizeof...(Symbols);
 
+  Expression expression;
 
+  constexpr compiled_formula(Expression expr) noexcept : expression(expr) {}
+
+  // Positional call: f(x_val, y_val, z_val)
+  template<typename... Values>
+    requires(sizeof...(Values) == arity)
+  constexpr auto operator()(Values... values) const noexcept
+  {
+    return expression(positional_substitution<symbols_type, Values...>(values...));
+  }
+
+  // Array call: one element per symbol, in compile order
+  template<typename T, std::size_t N>
+    requires(N == arity)
+  constexpr auto operator()(const std::array<T, N>& values) const noexcept
+  {
+    return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+      // braced initialization keeps the loads in symbol order
+      return expression(positional_substitution<symbols_type, typename compile_detail::repeated_type<Is, T>::type...>{values[Is]...});
+    }(std::make_index_sequence<arity>{});
+  }
+
+  // Span call: a dynamic extent is checked, and std::out_of_range thrown when
+  // values holds fewer than arity elements
+  template<typename T, std::size_t Extent>
+    requires(Extent == arity || Extent == std::dynamic_extent)
+  constexpr auto operator()(std::span<T, Extent> values) const noexcept(Extent != std::dynamic_extent)
+  {
+    using value_type = std::remove_cv_t<T>;
+    if constexpr (Extent == std::dynamic_extent)
+      if (values.size() < arity)
+        throw std::out_of_range("compile: the span holds fewer values than there are symbols");
+    return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+      // braced initialization keeps the loads in symbol order
+      return expression(
+        positional_substitution<symbols_type, typename compile_detail::repeated_type<Is, value_type>::type...>{values[Is]...});
+    }(std::make_index_sequence<arity>{});
+  }
+};
+
+template<symbolic Expression, typename... Symbols>
+  requires(is_symbol_v<Symbols> && ...)
+constexpr auto compile(const Expression& expr, const Symbols&...) noexcept
+{
+  return compiled_formula<Expression, std::remove_cvref_t<Symbols>...>(expr);
+}
+
+template<symbolic Expression, typename... Symbols>
+  requires(is_symbol_v<Symbols> && ...)
+constexpr auto compile(const formula<Expression>& f, const Symbols&... symbols) noexcept
+{
+  return compile(f.expression, symbols...);
+}
 
 } // end namespace lam::symbols
@@ -23,25 +23,25 @@ import :engine;
 export namespace lam::symbols
 {
 // some operators
-template<symbolic_or_arithmetic Lhs, symbolic_or_arithmetic Rhs>
+template<symbolic_or_numeric Lhs, symbolic_or_numeric Rhs>
   requires(symbolic<Lhs> || symbolic<Rhs>)
 constexpr auto operator+(Lhs lhs, Rhs rhs) noexcept
 {
   return simplify_add(lhs, rhs);
 }
-template<symbolic_or_arithmetic Lhs, symbolic_or_arithmetic Rhs>
+template<symbolic_or_numeric Lhs, symbolic_or_numeric Rhs>
   requires(symbolic<Lhs> || symbolic<Rhs>)
 constexpr auto operator-(Lhs lhs, Rhs rhs) noexcept
 {
   return simplify_sub(lhs, rhs);
 }
-template<symbolic_or_arithmetic Lhs, symbolic_or_arithmetic Rhs>
+template<symbolic_or_numeric Lhs, symbolic_or_numeric Rhs>
   requires(symbolic<Lhs> || symbolic<Rhs>)
 constexpr auto operator*(Lhs lhs, Rhs rhs) noexcept
 {
   return simplify_mul(lhs, rhs);
 }
-template<symbolic_or_arithmetic Lhs, symbolic_or_arithmetic Rhs>
+template<symbolic_or_numeric Lhs, symbolic_or_numeric Rhs>
   requires(symbolic<Lhs> || symbolic<Rhs>)
 constexpr auto operator/(Lhs lhs, Rhs rhs) noexcept
 {
@@ -53,7 +53,7 @@ constexpr auto operator-(Arg arg) noexcept
   return simplify_neg(arg);
 }
 
-template<symbolic_or_arithmetic Lhs, symbolic_or_arithmetic Rhs>
+template<symbolic_or_numeric Lhs, symbolic_or_numeric Rhs>
   requires(symbolic<Lhs> || symbolic<Rhs>)
 constexpr auto operator^(Lhs lhs, Rhs rhs) noexcept
 {
@@ -0,0 +1,322 @@
+/*
+ * Provided under CC0 1.0 Universal – Public Domain Dedication license
+ * Original Author: Vincent Reverdy (LAPP, France)
+ * Source: CppCon 2023 "Symbolic Calculus for High-performance Computing From Scratch Using C++23"
+ */
+
+/*
+ * lam.symbols:parallel
+ * Description: Multithreaded batch evaluation.
+ * Content: execution policies (seq, unseq, par, par_unseq), a reusable work-stealing
+ *          thread_pool, and evaluate_batch overloads taking a policy.
+ * Extending Author: Colin Ford
+ */
+
+module;
+
+import std;
+
+export module lam.symbols:parallel;
+import :traits;
+import :core;
+import :engine;
+import :batch;
+
+export namespace lam::symbols
+{
+
+class thread_pool;
+
+/*
+ *  Execution Policies
+ *  Mirror the standard policies. Parallel ones may name the pool to run on
+ *  and the number of points per chunk (0 picks a cache-sized chunk).
+ */
+namespace execution
+{
+struct sequenced_policy
+{};
+struct unsequenced_policy
+{};
+struct parallel_policy
+{
+  thread_pool* pool = nullptr;
+  std::size_t chunk_size = 0;
+
+  constexpr parallel_policy on(thread_pool& p) const noexcept { return {&p, chunk_size}; }
+  constexpr parallel_policy with_chunk_size(std::size_t n) const noexcept { return {pool, n}; }
+};
+struct parallel_unsequenced_policy
+{
+  thread_pool* pool = nullptr;
+  std::size_t chunk_size = 0;
+
+  constexpr parallel_unsequenced_policy on(thread_pool& p) const noexcept { return {&p, chunk_size}; }
+  constexpr parallel_unsequenced_policy with_chunk_size(std::size_t n) const noexcept { return {pool, n}; }
+};
+
+inline constexpr sequenced_policy seq{};
+inline constexpr unsequenced_policy unseq{};
+inline constexpr parallel_policy par{};
+inline constexpr parallel_unsequenced_policy par_unseq{};
+} // namespace execution
+
+// Trait: execution policy types
+template<typename T>
+struct is_execution_policy : std::false_type
+{};
+template<>
+struct is_execution_policy<execution::sequenced_policy> : std::true_type
+{};
+template<>
+struct is_execution_policy<execution::unsequenced_policy> : std::true_type
+{};
+template<>
+struct is_execution_policy<execution::parallel_policy> : std::true_type
+{};
+template<>
+struct is_execution_policy<execution::parallel_unsequenced_policy> : std::true_type
+{};
+template<typename T>
+constexpr bool is_execution_policy_v = is_execution_policy<std::remove_cvref_t<T>>::value;
+
+/*
+ *  Thread Pool
+ *  Workers sleep until a parallel_for is submitted. The range is cut into
+ *  chunks and each queue receives a contiguous run of them; a worker pops
+ *  from the back of its own queue and, once empty, steals from the front of
+ *  the others. The calling thread takes part through the last queue.
+ *  One parallel_for runs at a time (a body must not submit to its own pool)
+ *  and the body must not throw.
+ */
+
+inline constexpr std::size_t cache_line_size = 64;
+
+class thread_pool
+{
+public:
+  explicit thread_pool(std::size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+    : queues_(std::make_unique<worker_queue[]>(std::max<std::size_t>(threads, 1)))
+    , slots_(std::max<std::size_t>(threads, 1))
+  {
+    workers_.reserve(slots_ - 1);
+    for (std::size_t i = 0; i + 1 < slots_; ++i)
+      workers_.emplace_back([this, i](std::stop_token stop) { worker_loop(stop, i); });
+  }
+
+  ~thread_pool()
+  {
+    for (auto& worker : workers_)
+      worker.request_stop();
+    wake_.notify_all();
+  }
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  // Threads taking part in a parallel_for, the caller included
+  std::size_t concurrency() const noexcept { return slots_; }
+
+  // Runs body(first, last) over [0, count) in chunks of at most `grain` points
+  template<typename Body>
+  void parallel_for(std::size_t count, std::size_t grain, const Body& body)
+  {
+    grain = std::max<std::size_t>(grain, 1);
+    const std::size_t chunks = (count + grain - 1) / grain;
+    if (chunks <= 1 || slots_ == 1)
+    {
+      if (count > 0)
+        body(std::size_t{0}, count);
+      return;
+    }
+
+    std::scoped_lock submit(submit_mutex_);
+    const job current{&invoke_body<Body>, &body};
+    pending_.store(chunks, std::memory_order_relaxed);
+    for (std::size_t q = 0; q < slots_; ++q)
+    {
+      std::scoped_lock lock(queues_[q].mutex);
+      for (std::size_t c = chunks * q / slots_; c < chunks * (q + 1) / slots_; ++c)
+        queues_[q].tasks.push_back({&current, c * grain, std::min(count, (c + 1) * grain)});
+    }
+    {
+      std::scoped_lock lock(wake_mutex_);
+      ++generation_;
+    }
+    wake_.notify_all();
+
+    drain(slots_ - 1);
+    for (auto left = pending_.load(std::memory_order_acquire); left != 0;
+         left = pending_.load(std::memory_order_acquire))
+      pending_.wait(left, std::memory_order_acquire);
+  }
+
+  // Pool shared by policies that do not name one
+  static thread_pool& shared()
+  {
+    static thread_pool pool;
+    return pool;
+  }
+
+private:
+  struct job
+  {
+    void (*run)(const void*, std::size_t, std::size_t);
+    const void* body;
+  };
+
+  struct task
+  {
+    const job* owner;
+    std::size_t first;
+    std::size_t last;
+  };
+
+  struct alignas(cache_line_size) worker_queue
+  {
+    std::mutex mutex;
+    std::deque<task> tasks;
+  };
+
+  template<typename Body>
+  static void invoke_body(const void* body, std::size_t first, std::size_t last)
+  {
+    (*static_cast<const Body*>(body))(first, last);
+  }
+
+  bool try_pop(std::size_t self, task& out)
+  {
+    std::scoped_lock lock(queues_[self].mutex);
+    if (queues_[self].tasks.empty())
+      return false;
+    out = queues_[self].tasks.back();
+    queues_[self].tasks.pop_back();
+    return true;
+  }
+
+  bool try_steal(std::size_t self, task& out)
+  {
+    for (std::size_t offset = 1; offset < slots_; ++offset)
+    {
+      auto& victim = queues_[(self + offset) % slots_];
+      std::scoped_lock lock(victim.mutex);
+      if (!victim.tasks.empty())
+      {
+        out = victim.tasks.front();
+        victim.tasks.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void drain(std::size_t self)
+  {
+    task t;
+    while (try_pop(self, t) || try_steal(self, t))
+    {
+      t.owner->run(t.owner->body, t.first, t.last);
+      // the job lives on the submitting stack: only pool members are touched from here on
+      if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        pending_.notify_all();
+    }
+  }
+
+  void worker_loop(std::stop_token stop, std::size_t self)
+  {
+    std::uint64_t seen = 0;
+    while (true)
+    {
+      {
+        std::unique_lock lock(wake_mutex_);
+        if (!wake_.wait(lock, stop, [&] { return generation_ != seen; }))
+          return;
+        seen = generation_;
+      }
+      drain(self);
+    }
+  }
+
+  std::unique_ptr<worker_queue[]> queues_;
+  std::size_t slots_;
+  std::atomic<std::size_t> pending_{0};
+  std::mutex submit_mutex_;
+  std::mutex wake_mutex_;
+  std::condition_variable_any wake_;
+  std::uint64_t generation_ = 0;
+  std::vector<std::jthread> workers_; // last member: joined before the queues go away
+};
+
+/*
+ *  Policy-Driven Batch Evaluation
+ *  evaluate_batch(execution::par, expr, out, x = xs, ...) splits the points
+ *  into chunks run on a thread pool; every chunk writes its own slice of the
+ *  output, so no lock guards the results.
+ */
+
+// Points per chunk: enough for the inputs and output of a chunk to stay in a 64 KiB budget
+inline constexpr std::size_t batch_chunk_bytes = std::size_t{1} << 16;
+
+// Bytes one point reads from an input: broadcast scalars are free
+template<typename Input>
+constexpr std::size_t batch_point_bytes() noexcept
+{
+  if constexpr (batch_column<Input>)
+    return sizeof(std::ranges::range_value_t<Input>);
+  else
+    return 0;
+}
+
+template<typename T, typename... Inputs>
+constexpr std::size_t default_batch_chunk() noexcept
+{
+  constexpr std::size_t bytes_per_point = sizeof(T) + (0 + ... + batch_point_bytes<Inputs>());
+  // multiple of 64 points keeps every chunk but the last a whole number of vectors
+  return std::max<std::size_t>(64, batch_chunk_bytes / bytes_per_point / 64 * 64);
+}
+
+template<typename Policy, symbolic Expression, typename... Symbols, batch_output Output, typename... Inputs>
+  requires(is_execution_policy_v<Policy> && sizeof...(Inputs) == sizeof...(Symbols))
+void evaluate_batch(const Policy& policy, const compiled_formula<Expression, Symbols...>& kernel, Output&& out,
+                    const Inputs&... inputs)
+{
+  using policy_type = std::remove_cvref_t<Policy>;
+  using value_type = std::ranges::range_value_t<Output>;
+  constexpr bool vectorize = std::is_same_v<policy_type, execution::unsequenced_policy> ||
+                             std::is_same_v<policy_type, execution::parallel_unsequenced_policy>;
+
+  auto* data = std::ranges::data(out);
+  const std::size_t count = std::ranges::size(out);
+
+  if constexpr (std::is_same_v<policy_type, execution::sequenced_policy> ||
+                std::is_same_v<policy_type, execution::unsequenced_policy>)
+    evaluate_batch_range<vectorize>(kernel, data, 0, count, make_batch_source(inputs)...);
+  else
+  {
+    thread_pool& pool = policy.pool ? *policy.pool : thread_pool::shared();
+    const std::size_t grain = policy.chunk_size ? policy.chunk_size : default_batch_chunk<value_type, Inputs...>();
+    auto body = [&, sources = std::make_tuple(make_batch_source(inputs)...)](std::size_t first, std::size_t last) {
+      std::apply(
+        [&](const auto&... source) { evaluate_batch_range<vectorize>(kernel, data, first, last, source...); },
+        sources);
+    };
+    pool.parallel_for(count, grain, body);
+  }
+}
+
+template<typename Policy, symbolic Expression, batch_output Output, typename... Binders>
+  requires is_execution_policy_v<Policy>
+void evaluate_batch(const Policy& policy, const Expression& expr, Output&& out, const Binders&... binders)
+{
+  evaluate_batch(policy, compile(expr, std::remove_cvref_t<Binders>::symbol...), std::forward<Output>(out),
+                 binders()...);
+}
+
+template<typename Policy, symbolic Expression, batch_output Output, typename... Binders>
+  requires is_execution_policy_v<Policy>
+void evaluate_batch(const Policy& policy, const formula<Expression>& f, Output&& out, const Binders&... binders)
+{
+  evaluate_batch(policy, f.expression, std::forward<Output>(out), binders...);
+}
+
+} // end namespace lam::symbols
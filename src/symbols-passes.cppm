@@ -0,0 +1,396 @@
+/*
+ * Provided under CC0 1.0 Universal – Public Domain Dedication license
+ * Original Author: Vincent Reverdy (LAPP, France)
+ * Source: CppCon 2023 "Symbolic Calculus for High-performance Computing From Scratch Using C++23"
+ */
+
+/*
+ * lam.symbols:passes
+ * Description: Rewrites applied to a finished expression, before it is evaluated or compiled.
+ * Content: pairwise and compensated_plus N-ary operators, balance and compensate passes,
+ *          share_powers, reduce_strength.
+ * Note: rewritten nodes are opaque to the simplification patterns; run a pass last.
+ * Extending Author: Colin Ford
+ */
+
+module;
+
+import std;
+
+export module lam.symbols:passes;
+import :traits;
+import :core;
+import :chains;
+import :engine;
+import :bundle;
+
+export namespace lam::symbols
+{
+
+/*
+ *  Pairwise Reduction
+ *  pairwise<Op> reduces v0, ..., vn as a balanced tree, (v0 op v1) op (v2 op v3).
+ *  The dependency chain is log2(n) operations deep instead of n, so independent
+ *  halves issue in parallel, and the rounding error bound grows with log2(n).
+ */
+
+template<typename Op>
+struct pairwise
+{
+  // A partial evaluation keeps the node, and its operator, until every operand is a value
+  template<typename... Values>
+  constexpr auto operator()(const Values&... values) const
+  {
+    if constexpr ((is_symbolic_v<Values> || ...))
+      return symbolic_expression<pairwise, Values...>(values...);
+    else
+      return reduce<0, sizeof...(Values)>(std::forward_as_tuple(values...));
+  }
+
+  // Operands [First, Last)
+  template<std::size_t First, std::size_t Last, typename Tuple>
+  static constexpr auto reduce(const Tuple& values)
+  {
+    if constexpr (Last - First == 1)
+      return std::get<First>(values);
+    else
+    {
+      constexpr std::size_t mid = First + (Last - First) / 2;
+      return simplify_expression(Op{}, reduce<First, mid>(values), reduce<mid, Last>(values));
+    }
+  }
+};
+
+template<typename Op>
+struct is_nary_operator<pairwise<Op>> : std::true_type
+{};
+
+/*
+ *  Compensated Summation
+ *  Neumaier's variant of Kahan summation: the rounding error of every addition
+ *  is carried separately and added back at the end, so the error no longer
+ *  grows with the number of terms. Costs about four times a plain sum, and is
+ *  undone by -ffast-math (reassociation cancels the correction).
+ *  Operands that are not all floating point fall back to pairwise addition.
+ */
+
+struct compensated_plus
+{
+  template<typename... Values>
+  constexpr auto operator()(const Values&... values) const
+  {
+    // as for pairwise, a partial evaluation stays compensated
+    if constexpr ((is_symbolic_v<Values> || ...))
+      return symbolic_expression<compensated_plus, Values...>(values...);
+    else if constexpr ((std::is_floating_point_v<Values> && ...))
+    {
+      using T = std::common_type_t<Values...>;
+      T sum{0};
+      T correction{0};
+      (accumulate(sum, correction, static_cast<T>(values)), ...);
+      return sum + correction;
+    }
+    else
+      return pairwise<std::plus<void>>{}(values...);
+  }
+
+  template<typename T>
+  static constexpr void accumulate(T& sum, T& correction, T value)
+  {
+    const T total = sum + value;
+    // the low order bits lost are those of the smaller operand
+    if ((sum < 0 ? -sum : sum) >= (value < 0 ? -value : value))
+      correction += (sum - total) + value;
+    else
+      correction += (value - total) + sum;
+    sum = total;
+  }
+};
+
+template<>
+struct is_nary_operator<compensated_plus> : std::true_type
+{};
+
+/*
+ *  Passes
+ *  Each pass rebuilds the tree bottom up, Rule::op<Op, N> naming the operator
+ *  of a node with operator Op and N operands. Leaves are kept as they are.
+ */
+
+template<typename Rule, typename Term>
+constexpr auto rewrite_operators(const Term& term)
+{
+  if constexpr (is_symbolic_expression<Term>::value)
+    return std::apply(
+      [](const auto&... operand) {
+        using op = typename Rule::template op<expr_op_t<Term>, sizeof...(operand)>;
+        return symbolic_expression<op, decltype(rewrite_operators<Rule>(operand))...>(
+          rewrite_operators<Rule>(operand)...);
+      },
+      term.terms);
+  else
+    return term;
+}
+
+// Rule: flattened sums and products of three or more operands reduce pairwise
+struct balance_rule
+{
+  template<typename Op, std::size_t N>
+  using op = std::conditional_t<(N > 2) && (std::is_same_v<Op, std::plus<void>> ||
+                                            std::is_same_v<Op, std::multiplies<void>>),
+                                pairwise<Op>, Op>;
+};
+
+// Rule: sums of three or more operands, balanced or not, are compensated
+struct compensate_rule
+{
+  template<typename Op, std::size_t N>
+  using op = std::conditional_t<(N > 2) && (std::is_same_v<Op, std::plus<void>> ||
+                                            std::is_same_v<Op, pairwise<std::plus<void>>>),
+                                compensated_plus, Op>;
+};
+
+// balance(x0 + x1 + ... + x15) evaluates as a tree of depth 4 instead of a chain of 15
+template<symbolic Expression>
+constexpr auto balance(const Expression& expr)
+{ return rewrite_operators<balance_rule>(expr); }
+
+template<symbolic Expression>
+constexpr auto balance(const formula<Expression>& f)
+{ return formula{balance(f.expression)}; }
+
+// compensate(expr) sums every long sum of expr with Neumaier summation
+template<symbolic Expression>
+constexpr auto compensate(const Expression& expr)
+{ return rewrite_operators<compensate_rule>(expr); }
+
+template<symbolic Expression>
+constexpr auto compensate(const formula<Expression>& f)
+{ return formula{compensate(f.expression)}; }
+
+/*
+ *  Shared Powers
+ *  share_powers(x^2 + x^3 + x^5) evaluates every power of x from one addition
+ *  sequence, 1, 2, 3, 5, instead of one chain per power. Each rewritten node
+ *  still computes its own powers; they are identical multiplications of the
+ *  same value, and the compiler computes them once. Only stateless bases are
+ *  shared, and only the integer part of an exponent.
+ */
+
+template<auto C, typename Sequence>
+struct shared_power
+{
+  template<typename Base>
+  constexpr auto operator()(const Base& base) const
+  { return pow_by_constant<C, Sequence>(base); }
+};
+
+template<typename Base, std::size_t N>
+struct power_use
+{
+  using base = Base;
+  static constexpr std::size_t exponent = N;
+};
+
+// Trait: power node sharing its chain, base^c with c lowered for double and base stateless
+template<typename T>
+struct is_shared_power_site : std::false_type
+{};
+template<typename Base, auto C>
+struct is_shared_power_site<symbolic_expression<power<void>, Base, constant_symbol<C>>>
+  : std::bool_constant<is_stateless_v<Base> && is_lowered_exponent_v<C, double>>
+{};
+
+// Appends the (base, integer part of |c|) of a shared power node to List
+template<typename List, typename Expr, bool = is_shared_power_site<Expr>::value>
+struct append_power_use
+{ using type = List; };
+template<typename... Ts, typename Expr>
+struct append_power_use<type_list<Ts...>, Expr, true>
+{
+  static constexpr exponent_fraction e = constant_exponent<expr_rhs_t<Expr>::value>;
+  using use =
+    power_use<expr_lhs_t<Expr>, static_cast<std::size_t>((e.numerator < 0 ? -e.numerator : e.numerator) / e.denominator)>;
+  using type = std::conditional_t<type_list_contains_v<use, type_list<Ts...>>, type_list<Ts...>, type_list<Ts..., use>>;
+};
+
+// Every power use of Trees..., operands before the node
+template<typename List, typename... Trees>
+struct collect_power_uses
+{ using type = List; };
+
+template<typename List, typename Tree>
+struct collect_power_uses_of
+{ using type = List; };
+template<typename List, typename Op, typename... Terms>
+struct collect_power_uses_of<List, symbolic_expression<Op, Terms...>>
+{
+  using type = typename append_power_use<typename collect_power_uses<List, Terms...>::type,
+                                         symbolic_expression<Op, Terms...>>::type;
+};
+
+template<typename List, typename Tree, typename... Rest>
+struct collect_power_uses<List, Tree, Rest...>
+{
+  using type = typename collect_power_uses<typename collect_power_uses_of<List, Tree>::type, Rest...>::type;
+};
+
+// One power_sequence per base, holding every exponent used with it
+template<typename Base, typename Uses>
+struct shared_power_sequence;
+template<typename Base, typename... Uses>
+struct shared_power_sequence<Base, type_list<Uses...>>
+{ using type = power_sequence<(std::is_same_v<typename Uses::base, Base> ? Uses::exponent : 1)...>; };
+
+template<typename Uses, typename Term>
+constexpr auto share_power_chains(const Term& term)
+{
+  if constexpr (is_shared_power_site<Term>::value)
+  {
+    using sequence = typename shared_power_sequence<expr_lhs_t<Term>, Uses>::type;
+    auto base = share_power_chains<Uses>(get_lhs_val(term));
+    return symbolic_expression<shared_power<expr_rhs_t<Term>::value, sequence>, decltype(base)>(base);
+  }
+  else if constexpr (is_symbolic_expression<Term>::value)
+    return std::apply(
+      [](const auto&... operand) {
+        return symbolic_expression<expr_op_t<Term>, decltype(share_power_chains<Uses>(operand))...>(
+          share_power_chains<Uses>(operand)...);
+      },
+      term.terms);
+  else
+    return term;
+}
+
+template<symbolic Expression>
+constexpr auto share_powers(const Expression& expr)
+{ return share_power_chains<typename collect_power_uses<type_list<>, Expression>::type>(expr); }
+
+template<symbolic Expression>
+constexpr auto share_powers(const formula<Expression>& f)
+{ return formula{share_powers(f.expression)}; }
+
+/*
+ *  Strength Reduction
+ *  A division costs ten to twenty multiplications. reduce_strength(expr)
+ *  - merges a / b / c into a / (b * c),
+ *  - turns a / c, c a constant_symbol, into a * (1 / c), folded at compile time,
+ *  - turns every a / d, d stateless and the denominator of two or more
+ *    divisions, into a * reciprocal(d); the reciprocals are identical
+ *    divisions of the same value, and the compiler computes them once.
+ *  The results round differently (1 / 3 is inexact) and are floating point:
+ *  integers promote to double, like pow_by_constant.
+ */
+
+struct reciprocal
+{
+  template<typename T>
+  constexpr auto operator()(const T& value) const
+  {
+    using R = std::conditional_t<std::is_integral_v<T>, double, T>;
+    return R(R{1} / static_cast<R>(value));
+  }
+};
+
+// Trait: constant_symbol other than zero
+template<typename T>
+constexpr bool is_invertible_constant_v = false;
+template<auto C>
+constexpr bool is_invertible_constant_v<constant_symbol<C>> = C != 0;
+
+template<typename Term>
+constexpr auto merge_divisions(const Term& term)
+{
+  if constexpr (is_div_expr_v<Term>)
+  {
+    auto numerator = merge_divisions(get_lhs_val(term));
+    auto denominator = merge_divisions(get_rhs_val(term));
+    // Pattern: (a / b) / c → a / (b * c)
+    if constexpr (is_div_expr_v<decltype(numerator)>)
+      return simplify_div(get_lhs_val(numerator), simplify_mul(get_rhs_val(numerator), denominator));
+    else
+      return simplify_div(numerator, denominator);
+  }
+  else if constexpr (is_symbolic_expression<Term>::value)
+    return std::apply(
+      [](const auto&... operand) {
+        return symbolic_expression<expr_op_t<Term>, decltype(merge_divisions(operand))...>(merge_divisions(operand)...);
+      },
+      term.terms);
+  else
+    return term;
+}
+
+// Every denominator of Trees..., once per division
+template<typename List, typename... Trees>
+struct collect_denominators
+{ using type = List; };
+
+template<typename List, typename Tree>
+struct collect_denominators_of
+{ using type = List; };
+template<typename List, typename Op, typename... Terms>
+struct collect_denominators_of<List, symbolic_expression<Op, Terms...>>
+{ using type = typename collect_denominators<List, Terms...>::type; };
+template<typename... Ts, typename Numerator, typename Denominator>
+struct collect_denominators_of<type_list<Ts...>, symbolic_expression<std::divides<void>, Numerator, Denominator>>
+{ using type = typename collect_denominators<type_list<Ts..., Denominator>, Numerator, Denominator>::type; };
+
+template<typename List, typename Tree, typename... Rest>
+struct collect_denominators<List, Tree, Rest...>
+{
+  using type = typename collect_denominators<typename collect_denominators_of<List, Tree>::type, Rest...>::type;
+};
+
+template<typename Denominators, typename Term>
+constexpr auto reduce_divisions(const Term& term)
+{
+  if constexpr (is_div_expr_v<Term>)
+  {
+    using denominator_t = expr_rhs_t<Term>;
+    auto numerator = reduce_divisions<Denominators>(get_lhs_val(term));
+    auto denominator = reduce_divisions<Denominators>(get_rhs_val(term));
+    // Pattern: a / c → a * (1 / c), exact for an integer or rational c
+    if constexpr (is_invertible_constant_v<denominator_t>)
+      return simplify_mul(numerator, fold_constants(std::divides<void>{}, constant_symbol<1>{}, denominator_t{}));
+    // Pattern: a / d, d repeated → a * reciprocal(d)
+    else if constexpr (is_stateless_v<denominator_t> && type_list_count_v<denominator_t, Denominators> > 1)
+      return simplify_mul(numerator, symbolic_expression<reciprocal, decltype(denominator)>(denominator));
+    else
+      return symbolic_expression<std::divides<void>, decltype(numerator), decltype(denominator)>(numerator,
+                                                                                                denominator);
+  }
+  else if constexpr (is_symbolic_expression<Term>::value)
+    return std::apply(
+      [](const auto&... operand) {
+        return symbolic_expression<expr_op_t<Term>, decltype(reduce_divisions<Denominators>(operand))...>(
+          reduce_divisions<Denominators>(operand)...);
+      },
+      term.terms);
+  else
+    return term;
+}
+
+// reduce_strength(ax / r3 + ay / r3 + az / r3) divides once
+template<symbolic Expression>
+constexpr auto reduce_strength(const Expression& expr)
+{
+  auto merged = merge_divisions(expr);
+  return reduce_divisions<typename collect_denominators<type_list<>, decltype(merged)>::type>(merged);
+}
+
+template<symbolic Expression>
+constexpr auto reduce_strength(const formula<Expression>& f)
+{ return formula{reduce_strength(f.expression)}; }
+
+// Several outputs are reduced together and bundled: a denominator shared by
+// two outputs is one reciprocal, evaluated once by the bundle
+template<symbolic... Outputs>
+  requires(sizeof...(Outputs) > 1)
+constexpr auto reduce_strength(const Outputs&... outputs)
+{
+  using denominators = typename collect_denominators<type_list<>, decltype(merge_divisions(outputs))...>::type;
+  return formula_bundle{reduce_divisions<denominators>(merge_divisions(outputs))...};
+}
+
+} // end namespace lam::symbols
@@ -0,0 +1,350 @@
+/*
+ * Provided under CC0 1.0 Universal – Public Domain Dedication license
+ * Original Author: Vincent Reverdy (LAPP, France)
+ * Source: CppCon 2023 "Symbolic Calculus for High-performance Computing From Scratch Using C++23"
+ */
+
+/*
+ * lam.symbols:polynomial
+ * Description: Sums of c * x^k recognized as polynomials in x and evaluated as one.
+ * Content: polynomial_scheme, polynomial_evaluation (Horner, Estrin), monomial_degree,
+ *          horner, estrin and polynomial_form passes.
+ * Note: like the passes of :passes, the rewritten nodes are opaque to the simplifier.
+ * Extending Author: Colin Ford
+ */
+
+module;
+
+import std;
+
+export module lam.symbols:polynomial;
+import :traits;
+import :core;
+import :engine;
+
+export namespace lam::symbols
+{
+
+/*
+ *  Schemes
+ *  Horner, c0 + x*(c1 + x*(c2 + ...)), takes one multiply-add per degree, all
+ *  in one dependency chain. Estrin pairs the coefficients, (c0 + c1 x) +
+ *  (c2 + c3 x) x^2 + ..., then the pairs with x^4, and so on: a few more
+ *  multiplications, but a chain only 2 log2(degree) operations long.
+ *  automatic picks Estrin from estrin_min_degree on, when the node is built.
+ */
+
+enum class polynomial_scheme
+{
+  horner,
+  estrin,
+  automatic
+};
+
+inline constexpr std::size_t estrin_min_degree = 8;
+
+constexpr polynomial_scheme resolve_scheme(polynomial_scheme scheme, std::size_t degree)
+{
+  if (scheme != polynomial_scheme::automatic)
+    return scheme;
+  return degree >= estrin_min_degree ? polynomial_scheme::estrin : polynomial_scheme::horner;
+}
+
+// The coefficient of a power that does not appear: adding it or multiplying by it is free
+struct absent_coefficient
+{};
+
+template<typename Lhs, typename Rhs>
+constexpr auto coefficient_add(const Lhs& lhs, const Rhs& rhs)
+{
+  if constexpr (std::is_same_v<Lhs, absent_coefficient>)
+    return rhs;
+  else if constexpr (std::is_same_v<Rhs, absent_coefficient>)
+    return lhs;
+  else
+    return simplify_add(lhs, rhs);
+}
+
+template<typename Lhs, typename Rhs>
+constexpr auto coefficient_mul(const Lhs& lhs, const Rhs& rhs)
+{
+  if constexpr (std::is_same_v<Lhs, absent_coefficient> || std::is_same_v<Rhs, absent_coefficient>)
+    return absent_coefficient{};
+  else
+    return simplify_mul(lhs, rhs);
+}
+
+/*
+ *  polynomial_evaluation<Scheme, 0, 2, 5>(x, c0, c2, c5) is c0 + c2 x^2 + c5 x^5.
+ *  Powers lists the powers present, increasing; the operands are x and their
+ *  coefficients. After a partial substitution that leaves an operand
+ *  symbolic, the node is kept with its scheme, and evaluated once all are values.
+ */
+
+template<polynomial_scheme Scheme, std::size_t... Powers>
+  requires(sizeof...(Powers) > 0)
+struct polynomial_evaluation
+{
+  static constexpr std::size_t degree = std::max({Powers...});
+  static constexpr polynomial_scheme scheme = resolve_scheme(Scheme, degree);
+
+  // A partial evaluation keeps the node, and its scheme, until every operand is a value
+  template<typename X, typename... Coefficients>
+    requires(sizeof...(Coefficients) == sizeof...(Powers))
+  constexpr auto operator()(const X& x, const Coefficients&... coefficients) const
+  {
+    const std::tuple<const Coefficients&...> present(coefficients...);
+    if constexpr (is_symbolic_v<X> || (is_symbolic_v<Coefficients> || ...))
+      return symbolic_expression<polynomial_evaluation, X, Coefficients...>(x, coefficients...);
+    else if constexpr (scheme == polynomial_scheme::horner)
+      return horner_from<0>(x, present);
+    else
+      return estrin_block<0, std::bit_width(degree)>(x, present);
+  }
+
+  // Coefficient of x^K
+  template<std::size_t K, typename Tuple>
+  static constexpr auto coefficient(const Tuple& present)
+  {
+    constexpr std::size_t index = [] {
+      std::size_t found = sizeof...(Powers);
+      std::size_t i = 0;
+      ((Powers == K ? (found = i) : 0, ++i), ...);
+      return found;
+    }();
+    if constexpr (index == sizeof...(Powers))
+      return absent_coefficient{};
+    else
+      return std::get<index>(present);
+  }
+
+  // c_K + x * (c_{K+1} + x * (...))
+  template<std::size_t K, typename X, typename Tuple>
+  static constexpr auto horner_from(const X& x, const Tuple& present)
+  {
+    if constexpr (K == degree)
+      return coefficient<K>(present);
+    else
+      return coefficient_add(coefficient<K>(present), coefficient_mul(horner_from<K + 1>(x, present), x));
+  }
+
+  // x^(2^Level), by squaring
+  template<std::size_t Level, typename X>
+  static constexpr auto square_power(const X& x)
+  {
+    if constexpr (Level == 0)
+      return x;
+    else
+    {
+      const auto half = square_power<Level - 1>(x);
+      return simplify_mul(half, half);
+    }
+  }
+
+  // The 2^Level coefficients from First: low half + high half * x^(2^(Level-1))
+  template<std::size_t First, std::size_t Level, typename X, typename Tuple>
+  static constexpr auto estrin_block(const X& x, const Tuple& present)
+  {
+    if constexpr (First > degree)
+      return absent_coefficient{};
+    else if constexpr (Level == 0)
+      return coefficient<First>(present);
+    else
+    {
+      constexpr std::size_t half = std::size_t{1} << (Level - 1);
+      return coefficient_add(estrin_block<First, Level - 1>(x, present),
+                             coefficient_mul(estrin_block<First + half, Level - 1>(x, present),
+                                             square_power<Level - 1>(x)));
+    }
+  }
+};
+
+template<polynomial_scheme Scheme, std::size_t... Powers>
+struct is_nary_operator<polynomial_evaluation<Scheme, Powers...>> : std::true_type
+{};
+
+/*
+ *  Recognition
+ *  A term is a monomial in x when it is x, x^k with k a non-negative integer
+ *  constant_symbol, a product of such factors and factors free of x, or free
+ *  of x altogether. Its coefficient is the product of the factors free of x,
+ *  so coefficients may hold other symbols: a * x^2 + b * y * x + c.
+ */
+
+inline constexpr std::size_t not_a_monomial = std::numeric_limits<std::size_t>::max();
+
+template<typename Symbol, typename Term>
+struct monomial_degree
+  : std::integral_constant<std::size_t, contains_symbol_v<Term, Symbol> ? not_a_monomial : 0>
+{};
+template<typename Symbol>
+struct monomial_degree<Symbol, Symbol> : std::integral_constant<std::size_t, 1>
+{};
+template<typename Symbol, auto C>
+struct monomial_degree<Symbol, symbolic_expression<power<void>, Symbol, constant_symbol<C>>>
+  : std::integral_constant<std::size_t, [] {
+      if constexpr (std::is_integral_v<decltype(C)>)
+        return C >= 0 ? static_cast<std::size_t>(C) : not_a_monomial;
+      else
+        return not_a_monomial;
+    }()>
+{};
+template<typename Symbol, typename... Factors>
+struct monomial_degree<Symbol, symbolic_expression<std::multiplies<void>, Factors...>>
+  : std::integral_constant<std::size_t, [] {
+      std::size_t degree = 0;
+      for (std::size_t factor : {monomial_degree<Symbol, Factors>::value...})
+        degree = (degree == not_a_monomial || factor == not_a_monomial) ? not_a_monomial : degree + factor;
+      return degree;
+    }()>
+{};
+
+template<typename Symbol, typename Term>
+constexpr std::size_t monomial_degree_v = monomial_degree<std::remove_cvref_t<Symbol>, std::remove_cvref_t<Term>>::value;
+
+// acc times the factors free of Symbol
+template<typename Symbol, typename Acc>
+constexpr auto multiply_free_factors(const Acc& acc)
+{ return acc; }
+template<typename Symbol, typename Acc, typename Factor, typename... Rest>
+constexpr auto multiply_free_factors(const Acc& acc, const Factor& factor, const Rest&... rest)
+{
+  if constexpr (contains_symbol_v<Factor, Symbol>)
+    return multiply_free_factors<Symbol>(acc, rest...);
+  else
+    return multiply_free_factors<Symbol>(simplify_mul(acc, factor), rest...);
+}
+
+template<typename Symbol, typename Term>
+constexpr auto monomial_coefficient(const Term& term)
+{
+  if constexpr (!contains_symbol_v<Term, Symbol>)
+    return term;
+  else if constexpr (is_mul_expr_v<Term>)
+    return std::apply(
+      [](const auto&... factor) { return multiply_free_factors<Symbol>(constant_symbol<1>{}, factor...); },
+      term.terms);
+  else
+    return constant_symbol<1>{};
+}
+
+// acc plus the coefficients of the terms of degree K
+template<typename Symbol, std::size_t K, typename Acc>
+constexpr auto add_coefficients_of_degree(const Acc& acc)
+{ return acc; }
+template<typename Symbol, std::size_t K, typename Acc, typename Term, typename... Rest>
+constexpr auto add_coefficients_of_degree(const Acc& acc, const Term& term, const Rest&... rest)
+{
+  if constexpr (monomial_degree_v<Symbol, Term> == K)
+    return add_coefficients_of_degree<Symbol, K>(coefficient_add(acc, monomial_coefficient<Symbol>(term)), rest...);
+  else
+    return add_coefficients_of_degree<Symbol, K>(acc, rest...);
+}
+
+// Distinct degrees of a sum, increasing
+template<std::size_t N>
+struct degree_set
+{
+  std::array<std::size_t, N> degrees{};
+  std::size_t size = 0;
+  std::size_t highest = 0;
+};
+
+template<typename Symbol, typename... Terms>
+constexpr auto degrees_of_sum = [] {
+  degree_set<sizeof...(Terms)> set;
+  std::array<std::size_t, sizeof...(Terms)> all{monomial_degree_v<Symbol, Terms>...};
+  std::ranges::sort(all);
+  for (std::size_t degree : all)
+    if (set.size == 0 || set.degrees[set.size - 1] != degree)
+      set.degrees[set.size++] = degree;
+  set.highest = all.back();
+  return set;
+}();
+
+// Trait: a sum of monomials in Symbol of degree 2 or more
+template<typename Symbol, typename T>
+constexpr bool is_polynomial_sum_v = false;
+template<typename Symbol, typename... Terms>
+constexpr bool is_polynomial_sum_v<Symbol, symbolic_expression<std::plus<void>, Terms...>> =
+  ((monomial_degree_v<Symbol, Terms> != not_a_monomial) && ...) && degrees_of_sum<Symbol, Terms...>.highest >= 2;
+
+/*
+ *  Passes
+ *  horner(expr, x) rewrites every sum that is a polynomial in x, however deep
+ *  in expr, into one polynomial_evaluation node; estrin(expr, x) likewise, and
+ *  polynomial_form(expr, x) picks the scheme by degree. Given several symbols,
+ *  horner(expr, x, y) then rewrites the coefficients as polynomials in y.
+ */
+
+// One coefficient operand per degree present
+template<polynomial_scheme Scheme, typename Symbol, std::size_t... Ks, typename... Terms>
+constexpr auto make_polynomial(std::index_sequence<Ks...>, const Terms&... terms)
+{
+  constexpr auto set = degrees_of_sum<Symbol, Terms...>;
+  return symbolic_expression<polynomial_evaluation<resolve_scheme(Scheme, set.highest), set.degrees[Ks]...>, Symbol,
+                             decltype(add_coefficients_of_degree<Symbol, set.degrees[Ks]>(absent_coefficient{},
+                                                                                           terms...))...>(
+    Symbol{}, add_coefficients_of_degree<Symbol, set.degrees[Ks]>(absent_coefficient{}, terms...)...);
+}
+
+template<polynomial_scheme Scheme, typename Symbol, typename Term>
+constexpr auto rewrite_polynomials(const Term& term)
+{
+  if constexpr (is_polynomial_sum_v<Symbol, Term>)
+    return std::apply(
+      [](const auto&... terms) {
+        constexpr std::size_t count = degrees_of_sum<Symbol, std::remove_cvref_t<decltype(terms)>...>.size;
+        return make_polynomial<Scheme, Symbol>(std::make_index_sequence<count>{}, terms...);
+      },
+      term.terms);
+  else if constexpr (is_symbolic_expression<Term>::value)
+    return std::apply(
+      [](const auto&... operand) {
+        return symbolic_expression<expr_op_t<Term>, decltype(rewrite_polynomials<Scheme, Symbol>(operand))...>(
+          rewrite_polynomials<Scheme, Symbol>(operand)...);
+      },
+      term.terms);
+  else
+    return term;
+}
+
+// One symbol after the other: the coefficients of x become polynomials in y
+template<polynomial_scheme Scheme, typename Expression>
+constexpr auto rewrite_polynomials_in(const Expression& expr)
+{ return expr; }
+template<polynomial_scheme Scheme, typename Expression, typename Symbol, typename... Rest>
+constexpr auto rewrite_polynomials_in(const Expression& expr, const Symbol&, const Rest&... rest)
+{ return rewrite_polynomials_in<Scheme>(rewrite_polynomials<Scheme, Symbol>(expr), rest...); }
+
+template<symbolic Expression, typename... Symbols>
+  requires(sizeof...(Symbols) > 0 && (is_symbol_v<Symbols> && ...))
+constexpr auto horner(const Expression& expr, const Symbols&... symbols)
+{ return rewrite_polynomials_in<polynomial_scheme::horner>(expr, symbols...); }
+
+template<symbolic Expression, typename... Symbols>
+  requires(sizeof...(Symbols) > 0 && (is_symbol_v<Symbols> && ...))
+constexpr auto estrin(const Expression& expr, const Symbols&... symbols)
+{ return rewrite_polynomials_in<polynomial_scheme::estrin>(expr, symbols...); }
+
+template<symbolic Expression, typename... Symbols>
+  requires(sizeof...(Symbols) > 0 && (is_symbol_v<Symbols> && ...))
+constexpr auto polynomial_form(const Expression& expr, const Symbols&... symbols)
+{ return rewrite_polynomials_in<polynomial_scheme::automatic>(expr, symbols...); }
+
+template<symbolic Expression, typename... Symbols>
+  requires(sizeof...(Symbols) > 0 && (is_symbol_v<Symbols> && ...))
+constexpr auto horner(const formula<Expression>& f, const Symbols&... symbols)
+{ return formula{horner(f.expression, symbols...)}; }
+
+template<symbolic Expression, typename... Symbols>
+  requires(sizeof...(Symbols) > 0 && (is_symbol_v<Symbols> && ...))
+constexpr auto estrin(const formula<Expression>& f, const Symbols&... symbols)
+{ return formula{estrin(f.expression, symbols...)}; }
+
+template<symbolic Expression, typename... Symbols>
+  requires(sizeof...(Symbols) > 0 && (is_symbol_v<Symbols> && ...))
+constexpr auto polynomial_form(const formula<Expression>& f, const Symbols&... symbols)
+{ return formula{polynomial_form(f.expression, symbols...)}; }
+
+} // end namespace lam::symbols
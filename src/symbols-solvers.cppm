@@ -0,0 +1,198 @@
+/*
+ * Provided under CC0 1.0 Universal – Public Domain Dedication license
+ * Original Author: Vincent Reverdy (LAPP, France)
+ * Source: CppCon 2023 "Symbolic Calculus for High-performance Computing From Scratch Using C++23"
+ */
+
+/*
+ * lam.symbols:solvers
+ * Description: Root finding for scalar equations, derivatives generated at compile time.
+ * Content: root_solver, newton_solver, halley_solver; scalar solves and batched
+ *          structure-of-arrays solves with per-lane convergence.
+ * Extending Author: Colin Ford
+ */
+
+module;
+
+#include "symbols-vectorize.hpp"
+
+import std;
+
+export module lam.symbols:solvers;
+import :traits;
+import :core;
+import :engine;
+import :batch;
+import :bundle;
+import :calculus;
+
+export namespace lam::symbols
+{
+
+/*
+ *  Root Solvers
+ *  newton_solver(f, x, a, b) solves f = 0 for x, a and b being parameters
+ *  given at each solve. f' is derived at compile time and f, f' are one
+ *  formula_bundle, so an iteration evaluates the subtrees they share once.
+ *  halley_solver adds f'' to the bundle and converges cubically. A lane has
+ *  converged once its step is at most tolerance * max(1, |x|).
+ */
+
+enum class root_method
+{
+  newton,
+  halley
+};
+
+template<typename T>
+struct root_result
+{
+  T root;
+  std::size_t iterations;
+  bool converged;
+};
+
+template<root_method Method, symbolic Residual, typename Symbol, typename... Parameters>
+  requires(is_symbol_v<Symbol> && (is_symbol_v<Parameters> && ...))
+struct root_solver
+{
+  using first_type = partial_t<Residual, Symbol>;
+  using bundle_type = std::conditional_t<Method == root_method::newton, formula_bundle<Residual, first_type>,
+                                         formula_bundle<Residual, first_type, partial_t<first_type, Symbol>>>;
+  using kernel_type = compiled_bundle<bundle_type, Symbol, Parameters...>;
+  static constexpr std::size_t parameters = sizeof...(Parameters);
+
+  kernel_type kernel;
+  double tolerance = 1e-12;
+  std::size_t max_iterations = 50;
+
+  constexpr root_solver(const Residual& residual)
+    : kernel([&] {
+        const auto first = derivative_of<Symbol>(residual);
+        if constexpr (Method == root_method::newton)
+          return compile(bundle_type(residual, first), Symbol{}, Parameters{}...);
+        else
+          return compile(bundle_type(residual, first, derivative_of<Symbol>(first)), Symbol{}, Parameters{}...);
+      }())
+  {}
+
+  // The correction to subtract from x: f / f' (Newton), 2 f f' / (2 f'^2 - f f'') (Halley)
+  template<typename T, typename... Values>
+  constexpr T step(const T& x, const Values&... values) const
+  {
+    const auto evaluated = kernel(x, values...);
+    const T f = static_cast<T>(std::get<0>(evaluated));
+    const T df = static_cast<T>(std::get<1>(evaluated));
+    if constexpr (Method == root_method::newton)
+      return f / df;
+    else
+    {
+      const T d2f = static_cast<T>(std::get<2>(evaluated));
+      return T{2} * f * df / (T{2} * df * df - f * d2f);
+    }
+  }
+
+  // False for a NaN or infinite correction: f' vanished or the residual is undefined here
+  template<typename T>
+  static constexpr bool is_defined(const T& delta)
+  { return delta - delta == T{0}; }
+
+  template<typename T>
+  constexpr bool is_converged(const T& delta, const T& x) const
+  {
+    using std::abs;
+    return abs(delta) <= static_cast<T>(tolerance) * std::max(T{1}, abs(x));
+  }
+
+  // Scalar solve from x0: solver(x0, a, b), the parameters in solver order
+  template<typename T, typename... Values>
+    requires(sizeof...(Values) == parameters)
+  constexpr root_result<T> operator()(T x, const Values&... values) const
+  {
+    for (std::size_t k = 1; k <= max_iterations; ++k)
+    {
+      const T delta = step(x, values...);
+      if (!is_defined(delta))
+        return {x, k, false};
+      x = x - delta;
+      if (is_converged(delta, x))
+        return {x, k, true};
+    }
+    return {x, max_iterations, false};
+  }
+
+  /*
+   *  solve_batch(roots, converged, as, bs) solves every lane i from roots[i],
+   *  writing the root back to roots[i] and whether it converged to
+   *  converged[i]. Parameters are columns or broadcast scalars, as in
+   *  evaluate_batch. Each iteration sweeps every lane, a converged lane
+   *  keeping its root, until all have converged or max_iterations. As in
+   *  the scalar solve, a lane whose correction is undefined keeps its last
+   *  root and is retired unconverged. Returns the number of converged lanes.
+   *  Precondition: every column holds at least std::ranges::size(roots) values.
+   */
+  template<batch_output Roots, batch_output Mask, typename... Inputs>
+    requires(sizeof...(Inputs) == parameters)
+  constexpr std::size_t solve_batch(Roots&& roots, Mask&& converged, const Inputs&... inputs) const
+  {
+    const std::size_t count = std::ranges::size(roots);
+    auto* x = std::ranges::data(roots);
+    auto* done = std::ranges::data(converged);
+    for (std::size_t i = 0; i < count; ++i)
+      done[i] = false;
+    return solve_lanes(x, done, count, make_batch_source(inputs)...);
+  }
+
+  template<typename T, typename Flag, typename... Sources>
+  constexpr std::size_t solve_lanes(T* x, Flag* done, std::size_t count, const Sources&... sources) const
+  {
+    std::vector<unsigned char> failed(count, 0);
+    std::size_t remaining = count;
+    for (std::size_t k = 0; k < max_iterations && remaining > 0; ++k)
+    {
+      LAM_SYMBOLS_VECTORIZE_LOOP
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        const T delta = step(x[i], sources[i]...);
+        const T next = x[i] - delta;
+        const bool active = !done[i] && !failed[i];
+        const bool defined = is_defined(delta);
+        x[i] = active && defined ? next : x[i];
+        failed[i] = failed[i] || (active && !defined);
+        done[i] = done[i] || (active && defined && is_converged(delta, next));
+      }
+      remaining = 0;
+      for (std::size_t i = 0; i < count; ++i)
+        remaining += !done[i] && !failed[i];
+    }
+    return static_cast<std::size_t>(std::count(done, done + count, true));
+  }
+};
+
+template<symbolic Residual, typename Symbol, typename... Parameters>
+  requires(is_symbol_v<Symbol> && (is_symbol_v<Parameters> && ...))
+constexpr auto newton_solver(const Residual& residual, const Symbol&, const Parameters&...)
+{
+  return root_solver<root_method::newton, Residual, std::remove_cvref_t<Symbol>, std::remove_cvref_t<Parameters>...>(
+    residual);
+}
+
+template<symbolic Residual, typename Symbol, typename... Parameters>
+  requires(is_symbol_v<Symbol> && (is_symbol_v<Parameters> && ...))
+constexpr auto halley_solver(const Residual& residual, const Symbol&, const Parameters&...)
+{
+  return root_solver<root_method::halley, Residual, std::remove_cvref_t<Symbol>, std::remove_cvref_t<Parameters>...>(
+    residual);
+}
+
+template<symbolic Residual, typename Symbol, typename... Parameters>
+  requires(is_symbol_v<Symbol> && (is_symbol_v<Parameters> && ...))
+constexpr auto newton_solver(const formula<Residual>& f, const Symbol& symbol, const Parameters&... parameters)
+{ return newton_solver(f.expression, symbol, parameters...); }
+
+template<symbolic Residual, typename Symbol, typename... Parameters>
+  requires(is_symbol_v<Symbol> && (is_symbol_v<Parameters> && ...))
+constexpr auto halley_solver(const formula<Residual>& f, const Symbol& symbol, const Parameters&... parameters)
+{ return halley_solver(f.expression, symbol, parameters...); }
+
+} // end namespace lam::symbols
@@ -0,0 +1,196 @@
+/*
+ * Provided under CC0 1.0 Universal – Public Domain Dedication license
+ * Original Author: Vincent Reverdy (LAPP, France)
+ * Source: CppCon 2023 "Symbolic Calculus for High-performance Computing From Scratch Using C++23"
+ */
+
+/*
+ * lam.symbols:stencils
+ * Description: Finite difference stencils with exact weights solved at compile time.
+ * Content: stencil, central_stencil_t, forward_stencil_t, backward_stencil_t, grid_value.
+ * Note: the weights are integers over one common denominator, so the emitted
+ *       expression holds int constant_symbols only and folds like any other.
+ * Extending Author: Colin Ford
+ */
+
+module;
+
+import std;
+
+export module lam.symbols:stencils;
+import :traits;
+import :core;
+import :engine;
+import :calculus;
+
+export namespace lam::symbols
+{
+
+/*
+ *  Grid Values
+ *  grid_value<o, axis> is the symbol for u at o steps along axis from the
+ *  point of a stencil: stencil<2, -1, 0, 1>::on_grid<1>(h) is the second
+ *  difference along axis 1. Offset 0 is the same point on every axis, and
+ *  grid_value<0, a> the same symbol whatever a, so a sum of differences along
+ *  several axes binds the centre once.
+ */
+
+template<int Offset, std::size_t Axis>
+struct grid_tag
+{};
+
+template<int Offset, std::size_t Axis = 0>
+using grid_value = symbol<unconstrained, symbol_id<grid_tag<Offset, Offset == 0 ? 0 : Axis>>{}>;
+
+/*
+ *  Stencils
+ *  stencil<D, Offsets...> approximates the D-th derivative of u at a grid point
+ *  from u at the points Offsets... grid steps away, exactly for polynomials of
+ *  degree below the number of points. The weight of offset o_k is D! times the
+ *  coefficient of x^D in the Lagrange basis polynomial of o_k, a ratio of
+ *  integers: numerators[k] / denominator. apply(h, u...) emits
+ *    (numerators[0] * u_0 + ... + numerators[n-1] * u_(n-1)) / (denominator * h^D)
+ *  through simplify_*, so zero weights vanish and the result fuses with any
+ *  other expression, a coefficient times a Laplacian for one; with numbers for
+ *  h and u it returns the difference itself. accuracy is the order of the
+ *  truncation error in h.
+ */
+
+template<int Derivative, int... Offsets>
+struct stencil
+{
+  static constexpr std::size_t points = sizeof...(Offsets);
+  static constexpr std::array<int, points> offsets{Offsets...};
+  static_assert(Derivative >= 0 && points > static_cast<std::size_t>(Derivative),
+                "stencil: a derivative of order D needs at least D + 1 points");
+  static_assert([] {
+    for (std::size_t k = 0; k < points; ++k)
+      for (std::size_t j = k + 1; j < points; ++j)
+        if (offsets[k] == offsets[j])
+          return false;
+    return true;
+  }(), "stencil: each offset may only appear once");
+
+  // Weight k as an irreducible fraction {numerator, denominator}
+  static constexpr std::pair<std::int64_t, std::int64_t> weight(std::size_t k)
+  {
+    // coefficients of prod_(j != k) (x - o_j), lowest degree first
+    std::array<std::int64_t, points> polynomial{1};
+    std::int64_t denominator = 1;
+    std::size_t degree = 0;
+    for (std::size_t j = 0; j < points; ++j)
+    {
+      if (j == k)
+        continue;
+      for (std::size_t m = ++degree; m > 0; --m)
+        polynomial[m] = polynomial[m - 1] - offsets[j] * polynomial[m];
+      polynomial[0] = -offsets[j] * polynomial[0];
+      denominator *= offsets[k] - offsets[j];
+    }
+    std::int64_t numerator = polynomial[Derivative];
+    for (int i = 2; i <= Derivative; ++i)
+      numerator *= i;
+    const std::int64_t divisor = std::gcd(numerator, denominator) * (denominator < 0 ? -1 : 1);
+    return {numerator / divisor, denominator / divisor};
+  }
+
+  static constexpr std::int64_t denominator = [] {
+    std::int64_t common = 1;
+    for (std::size_t k = 0; k < points; ++k)
+      common = std::lcm(common, weight(k).second);
+    return common;
+  }();
+
+  static constexpr std::array<std::int64_t, points> numerators = [] {
+    std::array<std::int64_t, points> scaled{};
+    for (std::size_t k = 0; k < points; ++k)
+      scaled[k] = weight(k).first * (denominator / weight(k).second);
+    return scaled;
+  }();
+
+  // apply spells the weights as constant_symbol<int>
+  static_assert([] {
+    constexpr auto fits = [](std::int64_t v) { return std::in_range<int>(v); };
+    for (std::size_t k = 0; k < points; ++k)
+      if (!fits(numerators[k]))
+        return false;
+    return fits(denominator);
+  }(), "stencil: the weights of this stencil do not fit in int");
+
+  // The first moment sum_k w_k o_k^m past the exact ones that does not vanish, less D
+  static constexpr std::size_t accuracy = [] {
+    for (std::size_t m = points;; ++m)
+    {
+      std::int64_t moment = 0;
+      for (std::size_t k = 0; k < points; ++k)
+      {
+        std::int64_t power = 1;
+        for (std::size_t i = 0; i < m; ++i)
+          power *= offsets[k];
+        moment += numerators[k] * power;
+      }
+      if (moment != 0)
+        return m - static_cast<std::size_t>(Derivative);
+    }
+  }();
+
+  // The values of u at Offsets..., in order, and the grid step
+  template<typename Spacing, typename... Values>
+    requires(sizeof...(Values) == points)
+  static constexpr auto apply(const Spacing& h, const Values&... values)
+  {
+    if constexpr (is_numeric_value_v<Spacing> && (is_numeric_value_v<Values> && ...))
+    {
+      // plain numbers: the difference itself
+      using value_type = std::common_type_t<Spacing, Values...>;
+      value_type sum{0};
+      std::size_t k = 0;
+      ((sum = sum + static_cast<value_type>(numerators[k++]) * static_cast<value_type>(values)), ...);
+      return sum / (static_cast<value_type>(denominator) * pow_by_constant<Derivative>(static_cast<value_type>(h)));
+    }
+    else
+      return [&]<std::size_t... Ks>(std::index_sequence<Ks...>) {
+        return simplify_div(
+          simplify_sum(simplify_mul(constant_symbol<static_cast<int>(numerators[Ks])>{}, values)...),
+          simplify_mul(constant_symbol<static_cast<int>(denominator)>{},
+                       simplify_pow(h, constant_symbol<Derivative>{})));
+      }(std::make_index_sequence<points>{});
+  }
+
+  // Over grid_value<Offsets, Axis>...
+  template<std::size_t Axis = 0, typename Spacing>
+  static constexpr auto on_grid(const Spacing& h)
+  { return apply(h, grid_value<Offsets, Axis>{}...); }
+};
+
+// Offsets First, First + 1, ..., First + Count - 1
+template<int Derivative, int First, typename Sequence>
+struct contiguous_stencil;
+template<int Derivative, int First, std::size_t... Is>
+struct contiguous_stencil<Derivative, First, std::index_sequence<Is...>>
+{
+  using type = stencil<Derivative, First + static_cast<int>(Is)...>;
+};
+
+template<int Derivative, int First, std::size_t Count>
+using contiguous_stencil_t = typename contiguous_stencil<Derivative, First, std::make_index_sequence<Count>>::type;
+
+// Symmetric about 0, Accuracy even
+template<int Derivative, int Accuracy>
+  requires(Derivative > 0 && Accuracy > 0 && Accuracy % 2 == 0)
+using central_stencil_t =
+  contiguous_stencil_t<Derivative, -((Derivative + 1) / 2 - 1 + Accuracy / 2),
+                       static_cast<std::size_t>(2 * ((Derivative + 1) / 2 - 1 + Accuracy / 2) + 1)>;
+
+// Offsets 0 to Derivative + Accuracy - 1
+template<int Derivative, int Accuracy>
+  requires(Derivative > 0 && Accuracy > 0)
+using forward_stencil_t = contiguous_stencil_t<Derivative, 0, static_cast<std::size_t>(Derivative + Accuracy)>;
+
+// Offsets -(Derivative + Accuracy - 1) to 0
+template<int Derivative, int Accuracy>
+  requires(Derivative > 0 && Accuracy > 0)
+using backward_stencil_t =
+  contiguous_stencil_t<Derivative, 1 - (Derivative + Accuracy), static_cast<std::size_t>(Derivative + Accuracy)>;
+
+} // end namespace lam::symbols
@@ -7,7 +7,7 @@
 /*
  * lam.symbols:traits
  * Description: Low-level metaprogramming helpers and concept definitions.
- * Content: remove_cvref extensions, index_constant, is_symbolic concepts.
+ * Content: remove_cvref extensions, index_constant, is_symbolic and numeric_value concepts.
  * Extending Author: Colin Ford
  */
 
@@ -98,4 +98,22 @@ inline constexpr bool is_symbolic_v = is_symbolic<T>::value;
 template <typename T>
 concept symbolic = is_symbolic_v<T>;
 
+/*
+ *  numeric values
+ *  Types the simplifier folds into a value once both operands are numeric.
+ *  Builtin arithmetic types and std::complex are numeric out of the box;
+ *  specialize is_numeric_value for SIMD packs, dual numbers, intervals...
+ */
+// Type trait
+template <typename T>
+struct is_numeric_value : std::bool_constant<std::is_arithmetic_v<T>> {};
+template <typename T>
+struct is_numeric_value<std::complex<T>> : std::true_type {};
+// Variable template
+template <typename T>
+inline constexpr bool is_numeric_value_v = is_numeric_value<std::remove_cvref_t<T>>::value;
+// Concept
+template <typename T>
+concept numeric_value = is_numeric_value_v<T>;
+
 } // end namespace lam::symbols
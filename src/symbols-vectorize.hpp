@@ -0,0 +1,21 @@
+/*
+ * symbols-vectorize.hpp
+ * Internal to lam.symbols, included from the global module fragment of the
+ * partitions with independent loops over points or lanes.
+ * LAM_SYMBOLS_VECTORIZE_LOOP, placed before such a loop, asks the compiler to
+ * vectorize it: every iteration reads its own inputs and writes its own output.
+ * Extending Author: Colin Ford
+ */
+
+#ifndef LAM_SYMBOLS_VECTORIZE_HPP
+#define LAM_SYMBOLS_VECTORIZE_HPP
+
+#if defined(__clang__)
+#define LAM_SYMBOLS_VECTORIZE_LOOP _Pragma("clang loop vectorize(enable) interleave(enable)")
+#elif defined(__GNUC__)
+#define LAM_SYMBOLS_VECTORIZE_LOOP _Pragma("GCC ivdep")
+#else
+#define LAM_SYMBOLS_VECTORIZE_LOOP
+#endif
+
+#endif // LAM_SYMBOLS_VECTORIZE_HPP
@@ -16,13 +16,25 @@ import std;
 export module lam.symbols;
 export import :traits;
 export import :core;
+export import :chains;
 export import :engine;
+export import :batch;
+export import :parallel;
+export import :bundle;
+export import :cache;
+export import :passes;
+export import :polynomial;
+export import :calculus;
+export import :dual;
+export import :solvers;
+export import :stencils;
 export import :operators;
 export import :config;
 
 // exercises for the reader...
 //  Partial substitution
 //    ✓ IMPLEMENTED: Partial substitution works - f(a = 5.0) returns a new symbolic expression
+//    ✓ IMPLEMENTED: bound subtrees fold to one value: (x * gm * m)(gm = 1.5, m = 4.0) -> 6.0 * x
 //  Rewriting
 //    ✓ IMPLEMENTED: Symbol rewriting works - f(x = y / z) generates a new formula
 //  Simplification
@@ -31,7 +43,24 @@ export import :config;
 //      - x - 0 -> x, x - x -> 0
 //      - x * 1 -> x, 1 * x -> x, x * 0 -> 0, 0 * x -> 0
 //      - x / 1 -> x, x / x -> 1 (when x != 0)
+//    ✓ IMPLEMENTED: sums and products keep a canonical operand order, so with ordered_symbol<N> x + y and y + x are one type
+//    ✓ IMPLEMENTED: products collect like factors: x * y * x -> x^2 * y, (2 * x) * (3 * y) -> 6 * x * y
+//    ✓ IMPLEMENTED: like terms with runtime coefficients merge: 2.0 * x - 2.0 * x -> 0.0 * x, (x + 1.0) - (x + 2.0) -> -1.0
+//      (the 0.0 * x node stays, and is still multiplied on every evaluation)
+//    ✓ IMPLEMENTED: exact constants: c<1> / c<3> -> c<rational{1, 3}>, c<rational{1, 2}> * c<2> -> 1, converted only at evaluation
+//  Common subexpression elimination
+//    ✓ IMPLEMENTED: formula_bundle{f, g, ...} evaluates shared stateless subtrees once
+//  Symbolic calculus
+//    ✓ IMPLEMENTED: derivative(expr, x) builds the simplified derivative type at compile time
+//    ✓ IMPLEMENTED: jacobian(std::tuple{f, g}, x, y) evaluates every nonzero partial in one bundle
+//    ✓ IMPLEMENTED: jacobian_sparsity gives constexpr CSR / CSC arrays and a column coloring for colored_jacobian
+//    ✓ IMPLEMENTED: hessian(expr, x, y) writes the upper triangle in packed symmetric storage
+//    ✓ IMPLEMENTED: gradient(expr, x, y) evaluates the value and the whole gradient in reverse mode
+//    ✓ IMPLEMENTED: dual<T, N> binders evaluate directional derivatives in forward mode
+//    ✓ IMPLEMENTED: taylor(expr, x, x0, c<n>) expands in powers of x with folded coefficients
+//    ✓ IMPLEMENTED: integrate(expr, x, a, b) integrates sums of k * x^n in closed form, folding constant bounds
+//    ✓ IMPLEMENTED: newton_solver / halley_solver solve f = 0, f and its derivatives in one bundle
+//    ✓ IMPLEMENTED: stencil<D, offsets...> solves exact finite difference weights and emits the difference
 //  Future enhancements:
-//    – More advanced simplification (factorization, common subexpression elimination)
-//    – Symbolic calculus (derivatives, integrals)
+//    – More advanced simplification (factorization)
 //    – Full blown custom rule-based rewriting
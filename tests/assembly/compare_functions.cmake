@@ -0,0 +1,64 @@
+# compare_functions.cmake
+# part of test suite for lam.symbols
+# Disassembles BINARY and checks every pair in PAIRS ("lhs=rhs,...") where lhs
+# is a generated kernel and rhs its handwritten twin. The kernel passes when it
+# makes no call and has no more instructions than the handwritten function.
+# Register choice and the operand order of commutative instructions are free to
+# differ between the two, so only the instruction count is compared.
+#
+# usage: cmake -DOBJDUMP=<objdump> -DBINARY=<exe> -DPAIRS="a=b,c=d" -P compare_functions.cmake
+
+execute_process(
+  COMMAND ${OBJDUMP} -d --no-show-raw-insn ${BINARY}
+  OUTPUT_VARIABLE disassembly
+  RESULT_VARIABLE result
+)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "objdump failed on ${BINARY}")
+endif()
+
+function(extract_body name out)
+  string(REGEX MATCH "<${name}>:\n([^\n]+\n)+" body "${disassembly}")
+  if(body STREQUAL "")
+    message(FATAL_ERROR "function ${name} not found in ${BINARY}")
+  endif()
+  string(REGEX REPLACE "<${name}>:\n" "" body "${body}")
+  # drop addresses and trailing comments
+  string(REGEX REPLACE "[ \t]*[0-9a-f]+:[ \t]*" "" body "${body}")
+  string(REGEX REPLACE "[ \t]*#[^\n]*" "" body "${body}")
+  string(REGEX REPLACE "[ \t]+" " " body "${body}")
+  # padding after the return does not belong to the function
+  string(REGEX REPLACE "(ret[^\n]*\n).*" "\\1" body "${body}")
+  set(${out} "${body}" PARENT_SCOPE)
+endfunction()
+
+function(count_instructions body out)
+  string(REGEX MATCHALL "\n" lines "${body}")
+  list(LENGTH lines count)
+  set(${out} ${count} PARENT_SCOPE)
+endfunction()
+
+string(REPLACE "," ";" PAIRS "${PAIRS}")
+set(failed FALSE)
+foreach(pair IN LISTS PAIRS)
+  string(REPLACE "=" ";" pair "${pair}")
+  list(GET pair 0 lhs)
+  list(GET pair 1 rhs)
+  extract_body(${lhs} lhs_body)
+  extract_body(${rhs} rhs_body)
+  count_instructions("${lhs_body}" lhs_count)
+  count_instructions("${rhs_body}" rhs_count)
+  if(lhs_body MATCHES "call|jmp [^\n]*<")
+    message(STATUS "${lhs} makes a call\n${lhs_body}")
+    set(failed TRUE)
+  elseif(lhs_count GREATER rhs_count)
+    message(STATUS "${lhs} (${lhs_count}) > ${rhs} (${rhs_count})\n--- ${lhs}\n${lhs_body}--- ${rhs}\n${rhs_body}")
+    set(failed TRUE)
+  else()
+    message(STATUS "${lhs} (${lhs_count}) <= ${rhs} (${rhs_count})")
+  endif()
+endforeach()
+
+if(failed)
+  message(FATAL_ERROR "generated kernels are larger than handwritten code")
+endif()
@@ -0,0 +1,67 @@
+/*
+ * compiled_kernel.cpp
+ * part of test suite for lam.symbols
+ * Assembly comparison: compile(expr, x, y, z) vs a handwritten function.
+ * Built at -O2; each compiled_* function should make no call and need no
+ * more instructions than its handwritten_* twin (see compare_functions.cmake).
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+using namespace lam::symbols;
+
+constexpr symbol x;
+constexpr symbol y;
+constexpr symbol z;
+constexpr symbol gm;
+
+// Kernel 1: x * y + z
+constexpr auto fma_like = compile(x * y + z, x, y, z);
+
+extern "C" __attribute__((noinline)) double compiled_fma_like(double a, double b, double c)
+{ return fma_like(a, b, c); }
+
+extern "C" __attribute__((noinline)) double handwritten_fma_like(double a, double b, double c)
+{ return a * b + c; }
+
+// Kernel 2: orbital style acceleration -gm * x / r3 (r3 passed in)
+constexpr auto accel = compile((-gm * x) / z, gm, x, z);
+
+extern "C" __attribute__((noinline)) double compiled_accel(double g, double px, double r3)
+{ return accel(g, px, r3); }
+
+extern "C" __attribute__((noinline)) double handwritten_accel(double g, double px, double r3)
+{ return -g * px / r3; }
+
+// Kernel 3: symbols passed in a different order than they appear
+constexpr auto reordered = compile((x - y) * (x + y), y, x);
+
+extern "C" __attribute__((noinline)) double compiled_reordered(double b, double a)
+{ return reordered(b, a); }
+
+extern "C" __attribute__((noinline)) double handwritten_reordered(double b, double a)
+{ return (a - b) * (a + b); }
+
+// Kernel 4: span overload, one load per symbol
+extern "C" __attribute__((noinline)) double compiled_span(const double* values)
+{ return fma_like(std::span<const double, 3>(values, 3)); }
+
+extern "C" __attribute__((noinline)) double handwritten_span(const double* values)
+{ return values[0] * values[1] + values[2]; }
+
+int main()
+{
+  volatile double a = 1.25, b = -2.5, c = 3.75;
+  const double values[3] = {a, b, c};
+
+  bool ok = true;
+  ok &= compiled_fma_like(a, b, c) == handwritten_fma_like(a, b, c);
+  ok &= compiled_accel(a, b, c) == handwritten_accel(a, b, c);
+  ok &= compiled_reordered(b, a) == handwritten_reordered(b, a);
+  ok &= compiled_span(values) == handwritten_span(values);
+
+  std::println("compiled kernels match handwritten: {}", ok ? "YES" : "NO");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,59 @@
+/*
+ * derivative_kernel.cpp
+ * part of test suite for lam.symbols
+ * Assembly check: compiled derivatives are as tight as hand-derived formulas.
+ * Built at -O2; the kernels should make no call and need no more instructions
+ * than their handwritten twins (see compare_functions.cmake).
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+using namespace lam::symbols;
+
+constexpr symbol x;
+constexpr symbol y;
+constexpr symbol z;
+
+// Kernel 1: d/dx (x^3 + 2 x y) = 3 x^2 + 2 y
+constexpr auto cubic = compile(derivative((x ^ constant_symbol<3>{}) + constant_symbol<2>{} * x * y, x), x, y);
+
+extern "C" __attribute__((noinline)) double compiled_cubic(double a, double b)
+{ return cubic(a, b); }
+
+extern "C" __attribute__((noinline)) double handwritten_cubic(double a, double b)
+{ return 3.0 * (a * a) + 2.0 * b; }
+
+// Kernel 2: d/dz (x z^2 + y z) = 2 x z + y
+constexpr auto quadratic = compile(derivative(x * (z ^ constant_symbol<2>{}) + y * z, z), x, y, z);
+
+extern "C" __attribute__((noinline)) double compiled_quadratic(double a, double b, double c)
+{ return quadratic(a, b, c); }
+
+extern "C" __attribute__((noinline)) double handwritten_quadratic(double a, double b, double c)
+{ return 2.0 * a * c + b; }
+
+// Kernel 3: d/dx (x / y) = 1 / y
+constexpr auto ratio = compile(derivative(x / y, x), x, y);
+
+extern "C" __attribute__((noinline)) double compiled_ratio(double a, double b)
+{ return ratio(a, b); }
+
+extern "C" __attribute__((noinline)) double handwritten_ratio(double, double b)
+{ return 1.0 / b; }
+
+int main()
+{
+  volatile double a = 1.25;
+  volatile double b = -0.5;
+  volatile double c = 3.0;
+
+  bool ok = true;
+  ok &= compiled_cubic(a, b) == handwritten_cubic(a, b);
+  ok &= compiled_quadratic(a, b, c) == handwritten_quadratic(a, b, c);
+  ok &= compiled_ratio(a, b) == handwritten_ratio(a, b);
+
+  std::println("derivative kernels match handwritten: {}", ok ? "YES" : "NO");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,37 @@
+# forbid_calls.cmake
+# part of test suite for lam.symbols
+# Disassembles BINARY and checks that none of FUNCTIONS ("f,g,...") calls or
+# jumps to any of CALLEES ("pow,powf,..."). Other calls are allowed: sqrt
+# keeps a call for errno on its slow path.
+#
+# usage: cmake -DOBJDUMP=<objdump> -DBINARY=<exe> -DFUNCTIONS="f,g" -DCALLEES="pow" -P forbid_calls.cmake
+
+execute_process(
+  COMMAND ${OBJDUMP} -d --no-show-raw-insn ${BINARY}
+  OUTPUT_VARIABLE disassembly
+  RESULT_VARIABLE result
+)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "objdump failed on ${BINARY}")
+endif()
+
+string(REPLACE "," "|" callees "${CALLEES}")
+string(REPLACE "," ";" FUNCTIONS "${FUNCTIONS}")
+set(failed FALSE)
+foreach(name IN LISTS FUNCTIONS)
+  # the whole function, up to the blank line before the next symbol
+  string(REGEX MATCH "<${name}>:\n([^\n]+\n)+" body "${disassembly}")
+  if(body STREQUAL "")
+    message(FATAL_ERROR "function ${name} not found in ${BINARY}")
+  endif()
+  if(body MATCHES "(call|jmp)[^\n]*<(${callees})(@plt)?>")
+    message(STATUS "${name} calls one of ${CALLEES}\n${body}")
+    set(failed TRUE)
+  else()
+    message(STATUS "${name} makes no call to ${CALLEES}")
+  endif()
+endforeach()
+
+if(failed)
+  message(FATAL_ERROR "generated kernels call a forbidden function")
+endif()
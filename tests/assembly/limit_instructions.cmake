@@ -0,0 +1,41 @@
+# limit_instructions.cmake
+# part of test suite for lam.symbols
+# Disassembles BINARY and checks every entry of FUNCTIONS ("f=n,g=m,...") uses
+# at most n instructions matching the regular expression INSTRUCTIONS, for
+# instance "v?div[sp][sd]" for floating point divisions.
+#
+# usage: cmake -DOBJDUMP=<objdump> -DBINARY=<exe> -DFUNCTIONS="f=1,g=0" -DINSTRUCTIONS="divsd" -P limit_instructions.cmake
+
+execute_process(
+  COMMAND ${OBJDUMP} -d --no-show-raw-insn ${BINARY}
+  OUTPUT_VARIABLE disassembly
+  RESULT_VARIABLE result
+)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "objdump failed on ${BINARY}")
+endif()
+
+string(REPLACE "," ";" FUNCTIONS "${FUNCTIONS}")
+set(failed FALSE)
+foreach(entry IN LISTS FUNCTIONS)
+  string(REPLACE "=" ";" entry "${entry}")
+  list(GET entry 0 name)
+  list(GET entry 1 limit)
+  # the whole function, up to the blank line before the next symbol
+  string(REGEX MATCH "<${name}>:\n([^\n]+\n)+" body "${disassembly}")
+  if(body STREQUAL "")
+    message(FATAL_ERROR "function ${name} not found in ${BINARY}")
+  endif()
+  string(REGEX MATCHALL "\t(${INSTRUCTIONS})[ \t\n]" found "${body}")
+  list(LENGTH found count)
+  if(count GREATER limit)
+    message(STATUS "${name} uses ${count} of ${INSTRUCTIONS}, more than ${limit}\n${body}")
+    set(failed TRUE)
+  else()
+    message(STATUS "${name} uses ${count} of ${INSTRUCTIONS} (at most ${limit})")
+  endif()
+endforeach()
+
+if(failed)
+  message(FATAL_ERROR "generated kernels use too many limited instructions")
+endif()
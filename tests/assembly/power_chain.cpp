@@ -0,0 +1,91 @@
+/*
+ * power_chain.cpp
+ * part of test suite for lam.symbols
+ * Assembly check: constant exponents never call pow.
+ * Built at -O2; the integer kernels should make no call and need no more
+ * instructions than their handwritten twins (see compare_functions.cmake),
+ * the sqrt/cbrt kernels should not call pow (see forbid_calls.cmake).
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+using namespace lam::symbols;
+
+constexpr symbol x;
+
+// Kernel 1: x * x * x, simplified to x^3
+constexpr auto cube = compile(x * x * x, x);
+
+extern "C" __attribute__((noinline)) double compiled_cube(double a)
+{ return cube(a); }
+
+extern "C" __attribute__((noinline)) double handwritten_cube(double a)
+{ return a * a * a; }
+
+// Kernel 2: x^15, five multiplications
+constexpr auto fifteen = compile(x ^ constant_symbol<15>{}, x);
+
+extern "C" __attribute__((noinline)) double compiled_fifteen(double a)
+{ return fifteen(a); }
+
+extern "C" __attribute__((noinline)) double handwritten_fifteen(double a)
+{
+  const double a2 = a * a;
+  const double a3 = a2 * a;
+  const double a6 = a3 * a3;
+  const double a12 = a6 * a6;
+  return a12 * a3;
+}
+
+// Kernel 3: x^-2, one reciprocal
+constexpr auto inverse_square = compile(x ^ constant_symbol<-2>{}, x);
+
+extern "C" __attribute__((noinline)) double compiled_inverse_square(double a)
+{ return inverse_square(a); }
+
+extern "C" __attribute__((noinline)) double handwritten_inverse_square(double a)
+{ return 1.0 / (a * a); }
+
+// Kernel 4: x^2 + x^3 + x^5 from one addition sequence
+constexpr auto shared = compile(share_powers((x ^ constant_symbol<2>{}) + (x ^ constant_symbol<3>{}) +
+                                             (x ^ constant_symbol<5>{})),
+                                x);
+
+extern "C" __attribute__((noinline)) double compiled_shared(double a)
+{ return shared(a); }
+
+extern "C" __attribute__((noinline)) double handwritten_shared(double a)
+{
+  const double a2 = a * a;
+  const double a3 = a2 * a;
+  const double a5 = a3 * a2;
+  return a2 + a3 + a5;
+}
+
+// Kernels 5 and 6: halves and exact thirds, sqrt or cbrt but no pow
+constexpr auto three_halves = compile(x ^ constant_symbol<1.5>{}, x);
+constexpr auto two_thirds = compile(x ^ constant_symbol<rational{2, 3}>{}, x);
+
+extern "C" __attribute__((noinline)) double compiled_three_halves(double a)
+{ return three_halves(a); }
+
+extern "C" __attribute__((noinline)) double compiled_two_thirds(double a)
+{ return two_thirds(a); }
+
+int main()
+{
+  volatile double a = 1.25;
+
+  bool ok = true;
+  ok &= compiled_cube(a) == handwritten_cube(a);
+  ok &= compiled_fifteen(a) == handwritten_fifteen(a);
+  ok &= compiled_inverse_square(a) == handwritten_inverse_square(a);
+  ok &= compiled_shared(a) == handwritten_shared(a);
+  ok &= std::abs(compiled_three_halves(a) - std::pow(a, 1.5)) < 1e-12;
+  ok &= std::abs(compiled_two_thirds(a) - std::pow(a, 2.0 / 3.0)) < 1e-12;
+
+  std::println("constant powers match handwritten: {}", ok ? "YES" : "NO");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,66 @@
+/*
+ * strength_reduction.cpp
+ * part of test suite for lam.symbols
+ * Assembly check: reduce_strength leaves one division per distinct denominator.
+ * Built at -O2; the kernels should make no call, need no more instructions than
+ * their handwritten twins (see compare_functions.cmake) and divide no more
+ * often than them (see limit_instructions.cmake).
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+using namespace lam::symbols;
+
+constexpr symbol x;
+constexpr symbol y;
+constexpr symbol z;
+constexpr symbol r;
+
+// Kernel 1: x / r^3 + y / r^3 + z / r^3, one reciprocal
+constexpr auto r3 = r ^ constant_symbol<3>{};
+constexpr auto force = compile(reduce_strength(x / r3 + y / r3 + z / r3), x, y, z, r);
+
+extern "C" __attribute__((noinline)) double compiled_force(double a, double b, double c, double d)
+{ return force(a, b, c, d); }
+
+extern "C" __attribute__((noinline)) double handwritten_force(double a, double b, double c, double d)
+{
+  const double inverse = 1.0 / (d * d * d);
+  return a * inverse + b * inverse + c * inverse;
+}
+
+// Kernel 2: x / y / z, one division by a product
+constexpr auto chained = compile(reduce_strength(x / y / z), x, y, z);
+
+extern "C" __attribute__((noinline)) double compiled_chained(double a, double b, double c)
+{ return chained(a, b, c); }
+
+extern "C" __attribute__((noinline)) double handwritten_chained(double a, double b, double c)
+{ return a / (b * c); }
+
+// Kernel 3: (x + y) / 8, no division at all
+constexpr auto eighth = compile(reduce_strength((x + y) / constant_symbol<8>{}), x, y);
+
+extern "C" __attribute__((noinline)) double compiled_eighth(double a, double b)
+{ return eighth(a, b); }
+
+extern "C" __attribute__((noinline)) double handwritten_eighth(double a, double b)
+{ return (a + b) * 0.125; }
+
+int main()
+{
+  volatile double a = 1.25;
+  volatile double b = -0.5;
+  volatile double c = 3.0;
+  volatile double d = 1.5;
+
+  bool ok = true;
+  ok &= compiled_force(a, b, c, d) == handwritten_force(a, b, c, d);
+  ok &= compiled_chained(a, b, c) == handwritten_chained(a, b, c);
+  ok &= compiled_eighth(a, b) == handwritten_eighth(a, b);
+
+  std::println("reduced divisions match handwritten: {}", ok ? "YES" : "NO");
+  return ok ? 0 : 1;
+}
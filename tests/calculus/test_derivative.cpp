@@ -0,0 +1,142 @@
+/*
+ * test_derivative.cpp
+ * part of test suite for lam.symbols
+ * derivative(expr, x): differentiation rules, simplification and custom unary operators
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+using namespace lam::test::utils::constants;
+
+constexpr symbol x;
+constexpr symbol y;
+constexpr symbol z;
+
+// Custom unary operators, differentiable once registered
+struct SinOp
+{
+  template<typename T>
+  constexpr auto operator()(const T& arg) const
+  { return std::sin(arg); }
+};
+struct CosOp
+{
+  template<typename T>
+  constexpr auto operator()(const T& arg) const
+  { return std::cos(arg); }
+};
+
+template<typename Expr>
+constexpr auto sin(const Expr& expr)
+{ return symbolic_expression<SinOp, Expr>{expr}; }
+template<typename Expr>
+constexpr auto cos(const Expr& expr)
+{ return symbolic_expression<CosOp, Expr>{expr}; }
+
+template<>
+struct lam::symbols::unary_derivative<SinOp>
+{
+  template<typename Arg>
+  constexpr auto operator()(const Arg& u) const
+  { return cos(u); }
+};
+template<>
+struct lam::symbols::unary_derivative<CosOp>
+{
+  template<typename Arg>
+  constexpr auto operator()(const Arg& u) const
+  { return -sin(u); }
+};
+
+// Central difference of f along the first argument
+template<typename F>
+double numeric_derivative(const F& f, double at, double other)
+{
+  const double h = 1e-6;
+  return (f(at + h, other) - f(at - h, other)) / (2.0 * h);
+}
+
+int main()
+{
+  // Test 1: leaves
+  static_assert(std::is_same_v<decltype(derivative(x, x)), constant_symbol<1>>);
+  static_assert(std::is_same_v<decltype(derivative(y, x)), constant_symbol<0>>);
+  static_assert(std::is_same_v<decltype(derivative(c<5>, x)), constant_symbol<0>>);
+  static_assert(std::is_same_v<decltype(derivative(y * z + (z ^ c<2>), x)), constant_symbol<0>>);
+  std::println("PASS: leaves");
+
+  // Test 2: polynomials come out simplified, as if written by hand
+  constexpr auto p = (x ^ c<3>) + c<2> * x * y;
+  constexpr auto dp = derivative(p, x);
+  static_assert(std::is_same_v<std::remove_cvref_t<decltype(dp)>,
+                               std::remove_cvref_t<decltype(c<3> * (x ^ c<2>) + c<2> * y)>>);
+  static_assert(dp(x = 2, y = 5) == 22);
+  static_assert(std::is_same_v<std::remove_cvref_t<decltype(derivative(p, y))>,
+                               std::remove_cvref_t<decltype(c<2> * x)>>);
+  std::println("PASS: polynomials");
+
+  // Test 3: products, quotients, negation and differences
+  constexpr auto q = (x * y - z) / (x + c<1>);
+  constexpr auto dq = derivative(q, x);
+  static_assert(dq(x = 1.0, y = 4.0, z = 2.0) == 1.5, "(y (x + 1) - (x y - z)) / (x + 1)^2");
+  static_assert(derivative(x / y, x)(x = 3.0, y = 4.0) == 0.25);
+  static_assert(derivative(-(x * x), x)(x = 3.0) == -6.0);
+  static_assert(derivative(y - x * z, x)(x = 1.0, y = 2.0, z = 7.0) == -7.0);
+  std::println("PASS: products and quotients");
+
+  // Test 4: powers, constant, fractional and symbolic exponents
+  static_assert(std::is_same_v<std::remove_cvref_t<decltype(derivative(x ^ c<1.5>, x))>,
+                               std::remove_cvref_t<decltype(c<1.5> * (x ^ c<0.5>))>>);
+  static_assert(std::is_same_v<std::remove_cvref_t<decltype(derivative(x ^ c<rational{1, 2}>, x))>,
+                               std::remove_cvref_t<decltype(c<rational{1, 2}> * (x ^ c<rational{-1, 2}>))>>,
+                "the new exponent is a canonical constant");
+  static_assert(!is_power_expr_v<std::remove_cvref_t<decltype(derivative(x ^ c<2.0>, x))>>, "2.0 - 1 is the int 1");
+  const double xv = 1.7;
+  const double yv = 0.6;
+  const auto check = [&](const char* name, double actual, double expected) {
+    if (!check_close(actual, expected, 1e-6))
+    {
+      std::println("FAIL: {} gave {}, expected {}", name, actual, expected);
+      return false;
+    }
+    return true;
+  };
+  if (!check("d(x^1.5)", derivative(x ^ c<1.5>, x)(x = xv), 1.5 * std::sqrt(xv)) ||
+      !check("d(x^y)/dx", derivative(x ^ y, x)(x = xv, y = yv), yv * std::pow(xv, yv - 1.0)) ||
+      !check("d(x^y)/dy", derivative(x ^ y, y)(x = xv, y = yv), std::pow(xv, yv) * std::log(xv)) ||
+      !check("d(x^x)", derivative(x ^ x, x)(x = xv), std::pow(xv, xv) * (std::log(xv) + 1.0)) ||
+      !check("d(2^x)", derivative(c<2> ^ x, x)(x = xv), std::pow(2.0, xv) * std::log(2.0)))
+    return 1;
+  std::println("PASS: powers");
+
+  // Test 5: registered unary operators, through the chain rule
+  constexpr auto wave = sin(x * x) * cos(y);
+  const auto dwave = derivative(wave, x);
+  if (!check("d sin(x^2) cos(y)", dwave(x = xv, y = yv), std::cos(xv * xv) * 2.0 * xv * std::cos(yv)) ||
+      !check("d2 sin(x^2) cos(y)", derivative(dwave, y)(x = xv, y = yv),
+             -std::cos(xv * xv) * 2.0 * xv * std::sin(yv)))
+    return 1;
+  std::println("PASS: unary operators");
+
+  // Test 6: derivatives compile like any expression, and agree with finite differences
+  constexpr auto potential = x * y / ((x * x + y * y) ^ c<1.5>);
+  const auto kernel = compile(derivative(potential, x), x, y);
+  const auto reference = compile(potential, x, y);
+  for (double at : {0.5, 1.0, 2.5})
+  {
+    if (!check("compiled derivative", kernel(at, yv), numeric_derivative(reference, at, yv)))
+      return 1;
+  }
+  const auto f = formula{potential};
+  if (!check("formula derivative", derivative(f, x)(x = xv, y = yv), kernel(xv, yv)))
+    return 1;
+  std::println("PASS: compiled derivatives");
+
+  return 0;
+}
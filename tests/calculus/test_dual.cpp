@@ -0,0 +1,99 @@
+/*
+ * test_dual.cpp
+ * part of test suite for lam.symbols
+ * dual<T, N> binders: forward mode derivatives through substitution, against derivative()
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+using namespace lam::test::utils::constants;
+
+constexpr symbol x;
+constexpr symbol y;
+constexpr symbol z;
+
+// A custom unary operator; dual provides exp by argument dependent lookup
+struct ExpOp
+{
+  template<typename T>
+  constexpr auto operator()(const T& arg) const
+  {
+    using std::exp;
+    return exp(arg);
+  }
+};
+
+template<>
+struct lam::symbols::unary_derivative<ExpOp>
+{
+  template<typename Arg>
+  constexpr auto operator()(const Arg& u) const
+  { return symbolic_expression<ExpOp, Arg>{u}; }
+};
+
+template<typename Expr>
+constexpr auto exp(const Expr& expr)
+{ return symbolic_expression<ExpOp, Expr>{expr}; }
+
+int main()
+{
+  using dual2 = dual<double, 2>;
+  static_assert(numeric_value<dual2>);
+
+  // Test 1: full substitution folds to a dual, at compile time too
+  constexpr auto poly = (x ^ c<3>) + c<2> * x * y - y;
+  constexpr auto p = poly(x = seed_dual<2>(2.0, 0), y = seed_dual<2>(5.0, 1));
+  static_assert(std::is_same_v<std::remove_cvref_t<decltype(p)>, dual2>);
+  static_assert(p.value == 23.0 && p.tangent == std::array{22.0, 3.0});
+  std::println("PASS: substitution returns a dual");
+
+  // Test 2: every rule agrees with derivative()
+  const auto expr = x * y * z / (y + c<1>) - (x ^ c<1.5>) + (y ^ z) + exp(x * z) + -(z * z) + (c<2> ^ x) +
+                    simplify_log(y) + (x ^ c<-2>) + (z ^ c<7>);
+  const auto d = expr(x = seed_dual<3>(1.3, 0), y = seed_dual<3>(0.7, 1), z = seed_dual<3>(1.1, 2));
+  const std::array expected{derivative(expr, x)(x = 1.3, y = 0.7, z = 1.1),
+                            derivative(expr, y)(x = 1.3, y = 0.7, z = 1.1),
+                            derivative(expr, z)(x = 1.3, y = 0.7, z = 1.1)};
+  if (!check_close(d.value, expr(x = 1.3, y = 0.7, z = 1.1), 1e-12))
+  {
+    std::println("FAIL: value {}", d.value);
+    return 1;
+  }
+  for (std::size_t i = 0; i < expected.size(); ++i)
+  {
+    if (!check_close(d.tangent[i], expected[i], 1e-10))
+    {
+      std::println("FAIL: tangent[{}] is {}, expected {}", i, d.tangent[i], expected[i]);
+      return 1;
+    }
+  }
+  std::println("PASS: agrees with derivative()");
+
+  // Test 3: duals mixed with plain values, partial substitution first
+  const auto partial = poly(y = 5.0);
+  const auto q = partial(x = dual<double>{2.0, {1.0}});
+  if (q.value != 23.0 || q.tangent[0] != 22.0)
+  {
+    std::println("FAIL: partial then dual gave {} + {} dx", q.value, q.tangent[0]);
+    return 1;
+  }
+  std::println("PASS: mixed binders");
+
+  // Test 4: compiled kernels and jvp, a directional derivative in one call
+  const auto kernel = compile(poly, x, y);
+  const auto v = jvp(kernel, std::array{2.0, 5.0}, std::array{1.0, -2.0});
+  if (v.value != 23.0 || v.tangent[0] != 22.0 - 2.0 * 3.0)
+  {
+    std::println("FAIL: jvp gave {} + {} t", v.value, v.tangent[0]);
+    return 1;
+  }
+  std::println("PASS: jvp");
+
+  return 0;
+}
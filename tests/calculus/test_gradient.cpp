@@ -0,0 +1,122 @@
+/*
+ * test_gradient.cpp
+ * part of test suite for lam.symbols
+ * gradient(expr, x, y, ...): reverse mode value and gradient, against derivative()
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+using namespace lam::test::utils::constants;
+
+constexpr symbol x;
+constexpr symbol y;
+constexpr symbol z;
+constexpr symbol w;
+
+struct SinOp
+{
+  template<typename T>
+  constexpr auto operator()(const T& arg) const
+  { return std::sin(arg); }
+};
+struct CosOp
+{
+  template<typename T>
+  constexpr auto operator()(const T& arg) const
+  { return std::cos(arg); }
+};
+
+template<>
+struct lam::symbols::unary_derivative<SinOp>
+{
+  template<typename Arg>
+  constexpr auto operator()(const Arg& u) const
+  { return symbolic_expression<CosOp, Arg>{u}; }
+};
+
+template<typename Expr>
+constexpr auto sin(const Expr& expr)
+{ return symbolic_expression<SinOp, Expr>{expr}; }
+
+// Generated symbols for a long sum
+template<std::size_t K>
+struct variable_tag
+{};
+template<std::size_t K>
+using variable = symbol<unconstrained, symbol_id<variable_tag<K>>{}>;
+
+int main()
+{
+  // Test 1: value and gradient, at compile time too
+  constexpr auto g = gradient((x ^ c<3>) + c<2> * x * y, x, y);
+  static_assert(g(2.0, 5.0).value == 28.0);
+  static_assert(g(2.0, 5.0).gradient == std::array{22.0, 4.0});
+  std::println("PASS: value and gradient");
+
+  // Test 2: every rule agrees with derivative()
+  const auto expr = x * y * z / (w + c<1>) - (x ^ c<1.5>) + (y ^ z) + sin(x * w) + -(z * z) + (c<2> ^ w);
+  const auto g2 = gradient(expr, x, y, z, w);
+  const auto [value, grad] = g2(1.3, 0.7, 2.1, 0.4);
+  const std::array expected{derivative(expr, x)(x = 1.3, y = 0.7, z = 2.1, w = 0.4),
+                            derivative(expr, y)(x = 1.3, y = 0.7, z = 2.1, w = 0.4),
+                            derivative(expr, z)(x = 1.3, y = 0.7, z = 2.1, w = 0.4),
+                            derivative(expr, w)(x = 1.3, y = 0.7, z = 2.1, w = 0.4)};
+  if (!check_close(value, expr(x = 1.3, y = 0.7, z = 2.1, w = 0.4), 1e-12))
+  {
+    std::println("FAIL: value {}", value);
+    return 1;
+  }
+  for (std::size_t i = 0; i < expected.size(); ++i)
+  {
+    if (!check_close(grad[i], expected[i], 1e-12))
+    {
+      std::println("FAIL: gradient[{}] is {}, expected {}", i, grad[i], expected[i]);
+      return 1;
+    }
+  }
+  std::println("PASS: agrees with derivative()");
+
+  // Test 3: products with a zero operand, no division by it
+  const auto p = gradient(x * y * z * w, x, y, z, w)(0.0, 2.0, 3.0, 4.0);
+  if (p.gradient != std::array{24.0, 0.0, 0.0, 0.0})
+  {
+    std::println("FAIL: product gradient at x = 0 is ({}, {}, {}, {})", p.gradient[0], p.gradient[1], p.gradient[2],
+                 p.gradient[3]);
+    return 1;
+  }
+  std::println("PASS: zero operands");
+
+  // Test 4: a symbol used in several places accumulates, a symbol absent gets zero
+  const auto q = gradient((x + y) * (x - y) + y / x, x, y, z)(3.0, 2.0, 7.0);
+  if (!check_close(q.gradient[0], 6.0 - 2.0 / 9.0) || !check_close(q.gradient[1], -4.0 + 1.0 / 3.0) ||
+      q.gradient[2] != 0.0)
+  {
+    std::println("FAIL: accumulated gradient ({}, {}, {})", q.gradient[0], q.gradient[1], q.gradient[2]);
+    return 1;
+  }
+  std::println("PASS: accumulation");
+
+  // Test 5: a flattened sum of 24 squares keeps its 24 operands
+  const auto squares = [&]<std::size_t... Ks>(std::index_sequence<Ks...>) {
+    const auto loss = ((variable<Ks>{} ^ c<2>) + ...);
+    static_assert(std::tuple_size_v<decltype(loss.terms)> == sizeof...(Ks));
+    return gradient(loss, variable<Ks>{}...)(static_cast<double>(Ks)...);
+  }(std::make_index_sequence<24>{});
+  for (std::size_t k = 0; k < 24; ++k)
+  {
+    if (squares.gradient[k] != 2.0 * static_cast<double>(k))
+    {
+      std::println("FAIL: d/dx{} of the sum of squares is {}", k, squares.gradient[k]);
+      return 1;
+    }
+  }
+  std::println("PASS: flattened sums");
+
+  return 0;
+}
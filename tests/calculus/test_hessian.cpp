@@ -0,0 +1,81 @@
+/*
+ * test_hessian.cpp
+ * part of test suite for lam.symbols
+ * hessian(expr, x, y, ...): upper triangle, packed and dense storage, against derivative()
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+using namespace lam::test::utils::constants;
+
+constexpr symbol x;
+constexpr symbol y;
+constexpr symbol z;
+constexpr symbol a;
+
+int main()
+{
+  // Test 1: layout, structural zeros dropped
+  constexpr auto h = hessian((x ^ c<3>) * y + (z ^ c<2>), x, y, z);
+  using H = decltype(h);
+  static_assert(H::order == 3 && H::packed_size == 6);
+  static_assert(H::packed_index(0, 0) == 0 && H::packed_index(0, 1) == 1 && H::packed_index(1, 1) == 2);
+  static_assert(H::packed_index(2, 0) == H::packed_index(0, 2) && H::packed_index(2, 2) == 5);
+  // xx = 6 x y, xy = 3 x^2, zz = 2; xz, yy and yz vanish
+  static_assert(H::nonzeros == 3);
+  std::println("PASS: upper triangle layout");
+
+  // Test 2: packed storage, at compile time too
+  static_assert([] {
+    std::array<double, 6> out{};
+    out.fill(-1.0);
+    hessian((x ^ c<3>) * y + (z ^ c<2>), x, y, z).packed(std::span(out), x = 2.0, y = 5.0, z = 1.0);
+    return out == std::array{60.0, 12.0, 0.0, 0.0, 0.0, 2.0};
+  }());
+  std::println("PASS: packed storage");
+
+  // Test 3: dense storage is symmetric and agrees with derivative()
+  const auto expr = x * y * z / (a + x) + (y ^ z) + x * x * y * y - z / y;
+  const auto full = hessian(expr, x, y, z);
+  std::array<double, 9> dense{};
+  full.dense(std::span(dense), x = 1.3, y = 0.7, z = 2.1, a = 0.4);
+  const auto second = [&](const auto& u, const auto& v) {
+    return derivative(derivative(expr, u), v)(x = 1.3, y = 0.7, z = 2.1, a = 0.4);
+  };
+  const std::array expected{second(x, x), second(x, y), second(x, z), second(y, x), second(y, y),
+                            second(y, z), second(z, x), second(z, y), second(z, z)};
+  for (std::size_t k = 0; k < 9; ++k)
+  {
+    if (!check_close(dense[k], expected[k], 1e-10))
+    {
+      std::println("FAIL: H({}, {}) is {}, expected {}", k / 3, k % 3, dense[k], expected[k]);
+      return 1;
+    }
+  }
+  std::println("PASS: dense storage");
+
+  // Test 4: compiled, the parameter after the differentiation symbols
+  const auto kernel = compile(full, x, y, z, a);
+  std::array<double, 6> packed{};
+  kernel.packed(std::span(packed), 1.3, 0.7, 2.1, 0.4);
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    for (std::size_t j = 0; j < 3; ++j)
+    {
+      if (!check_close(packed[kernel.packed_index(i, j)], dense[i * 3 + j], 1e-12))
+      {
+        std::println("FAIL: compiled H({}, {}) is {}", i, j, packed[kernel.packed_index(i, j)]);
+        return 1;
+      }
+    }
+  }
+  std::println("PASS: compiled kernel");
+
+  return 0;
+}
@@ -0,0 +1,80 @@
+/*
+ * test_integrate.cpp
+ * part of test suite for lam.symbols
+ * integrate(expr, x) and integrate(expr, x, a, b): power rule, symbolic coefficients, folded bounds
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+using namespace lam::test::utils::constants;
+
+constexpr symbol x;
+constexpr symbol y;
+
+int main()
+{
+  // Test 1: the power rule, coefficients folded with 1 / (n + 1)
+  constexpr auto cubic = c<3> * (x ^ c<2>) + c<4> * x + c<5>;
+  constexpr auto antiderivative = integrate(cubic, x);
+  static_assert(std::is_same_v<std::remove_cvref_t<decltype(antiderivative)>,
+                               std::remove_cvref_t<decltype((x ^ c<3>) + c<2> * (x ^ c<2>) + c<5> * x)>>);
+  if (!check_close(derivative(antiderivative, x)(x = 1.7), cubic(x = 1.7), 1e-12))
+  {
+    std::println("FAIL: d/dx of the antiderivative is {}", derivative(antiderivative, x)(x = 1.7));
+    return 1;
+  }
+  std::println("PASS: power rule");
+
+  // Test 2: negative and fractional exponents, 1 / x to log(x)
+  const auto powers = (x ^ c<-2>) + (x ^ c<0.5>) + c<3> / x + c<2> / (x ^ c<3>);
+  const auto primitive = integrate(powers, x);
+  const double at = 2.3;
+  const double expected = -1.0 / at + std::pow(at, 1.5) / 1.5 + 3.0 * std::log(at) - 1.0 / (at * at);
+  if (!check_close(primitive(x = at), expected, 1e-12))
+  {
+    std::println("FAIL: negative and fractional powers gave {}, expected {}", primitive(x = at), expected);
+    return 1;
+  }
+  std::println("PASS: negative and fractional exponents");
+
+  // Test 3: other symbols are constants
+  const auto mixed = integrate(y * (x ^ c<2>) - c<2> * x * y + y, x);
+  if (!check_close(mixed(x = 3.0, y = 2.0), 2.0 * 9.0 - 2.0 * 9.0 + 6.0, 1e-12))
+  {
+    std::println("FAIL: y x^2 - 2 x y + y gave {}", mixed(x = 3.0, y = 2.0));
+    return 1;
+  }
+  std::println("PASS: symbolic coefficients");
+
+  // Test 4: constant bounds fold to a constant_symbol
+  constexpr auto area = integrate(cubic, x, c<0>, c<2>);
+  static_assert(std::is_same_v<std::remove_cvref_t<decltype(area)>, constant_symbol<26>>);
+  constexpr auto third = integrate(x ^ c<2>, x, c<0>, c<1>);
+  static_assert(std::is_same_v<std::remove_cvref_t<decltype(third)>, constant_symbol<rational{1, 3}>>);
+  constexpr auto exact = integrate(c<rational{1, 2}> * (x ^ c<3>) - x, x, c<1>, c<rational{3, 2}>);
+  static_assert(std::is_same_v<std::remove_cvref_t<decltype(exact)>, constant_symbol<rational{-15, 128}>>);
+  std::println("PASS: constant bounds");
+
+  // Test 5: numeric bounds give a value, symbolic ones an expression
+  const double value = integrate(cubic, x, 0.5, 1.5);
+  if (!check_close(value, (3.375 + 4.5 + 7.5) - (0.125 + 0.5 + 2.5), 1e-12))
+  {
+    std::println("FAIL: numeric bounds gave {}", value);
+    return 1;
+  }
+  const auto upper = integrate(y * x, x, c<0>, y);
+  if (!check_close(upper(y = 2.0), 4.0, 1e-12))
+  {
+    std::println("FAIL: integral of y x from 0 to y gave {}", upper(y = 2.0));
+    return 1;
+  }
+  std::println("PASS: numeric and symbolic bounds");
+
+  return 0;
+}
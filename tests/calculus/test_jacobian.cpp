@@ -0,0 +1,102 @@
+/*
+ * test_jacobian.cpp
+ * part of test suite for lam.symbols
+ * jacobian(outputs, x, y, ...): sparsity layout, shared partials, dense and sparse output
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+using namespace lam::test::utils::constants;
+
+constexpr symbol x;
+constexpr symbol y;
+constexpr symbol z;
+constexpr symbol gm;
+
+template<std::size_t N>
+bool check_all(const char* name, const std::array<double, N>& actual, const std::array<double, N>& expected)
+{
+  for (std::size_t k = 0; k < N; ++k)
+  {
+    if (!check_close(actual[k], expected[k]))
+    {
+      std::println("FAIL: {} entry {} is {}, expected {}", name, k, actual[k], expected[k]);
+      return false;
+    }
+  }
+  return true;
+}
+
+int main()
+{
+  // Test 1: structural zeros are dropped at compile time, the rest listed row major
+  constexpr auto j = jacobian(std::tuple{x * y, x + (z ^ c<2>), y}, x, y, z);
+  using j_t = std::remove_cvref_t<decltype(j)>;
+  static_assert(j_t::rows == 3 && j_t::columns == 3 && j_t::nonzeros == 5);
+  static_assert(j_t::row_indices == std::array<std::size_t, 5>{0, 0, 1, 1, 2});
+  static_assert(j_t::column_indices == std::array<std::size_t, 5>{0, 1, 0, 2, 1});
+  std::println("PASS: sparsity layout");
+
+  // Test 2: dense and sparse output
+  std::array<double, 9> dense{};
+  dense.fill(-1.0);
+  j.dense(std::span(dense), x = 2.0, y = 3.0, z = 5.0);
+  if (!check_all("dense", dense, {3.0, 2.0, 0.0, 1.0, 0.0, 10.0, 0.0, 1.0, 0.0}))
+    return 1;
+  std::array<double, 5> sparse{};
+  j.sparse(std::span(sparse), x = 2.0, y = 3.0, z = 5.0);
+  if (!check_all("sparse", sparse, {3.0, 2.0, 1.0, 10.0, 1.0}))
+    return 1;
+  static_assert([] {
+    std::array<int, 9> out{};
+    jacobian(std::tuple{x * y, x + (z ^ c<2>), y}, x, y, z).dense(std::span(out), x = 2, y = 3, z = 5);
+    return out[5] == 10;
+  }(), "dense output at compile time");
+  std::println("PASS: dense and sparse output");
+
+  // Test 3: equal partials, and subtrees shared between partials, are evaluated once
+  constexpr auto k = jacobian(std::tuple{(x ^ c<3>) + y, (x ^ c<3>) - y * z}, x, y, z);
+  using k_bundle = typename std::remove_cvref_t<decltype(k)>::bundle_type;
+  using three_x_squared = std::remove_cvref_t<decltype(c<3> * (x ^ c<2>))>;
+  static_assert(type_list_contains_v<three_x_squared, typename k_bundle::shared_list>);
+  std::array<double, 6> shared{};
+  k.dense(std::span(shared), x = 2.0, y = 3.0, z = 5.0);
+  if (!check_all("shared", shared, {12.0, 1.0, 0.0, 12.0, -5.0, -3.0}))
+    return 1;
+  std::println("PASS: shared partials");
+
+  // Test 4: a formula_bundle gives the Jacobian of its original outputs
+  const auto radius = (x * x + y * y) ^ c<0.5>;
+  const auto bundle = formula_bundle{gm * x / radius, gm * y / radius};
+  const auto from_bundle = jacobian(bundle, x, y);
+  const auto from_tuple = jacobian(std::tuple{gm * x / radius, gm * y / radius}, x, y);
+  static_assert(std::is_same_v<decltype(from_bundle), decltype(from_tuple)>);
+  std::array<double, 4> lhs{};
+  std::array<double, 4> rhs{};
+  from_bundle.dense(std::span(lhs), x = 0.6, y = 0.8, gm = 2.0);
+  from_tuple.dense(std::span(rhs), x = 0.6, y = 0.8, gm = 2.0);
+  // d(gm x / r)/dx = gm y^2 / r^3 and d(gm x / r)/dy = -gm x y / r^3, with r = 1
+  if (!check_all("bundle", lhs, rhs) || !check_all("bundle values", lhs, {1.28, -0.96, -0.96, 0.72}))
+    return 1;
+  std::println("PASS: bundle Jacobian");
+
+  // Test 5: compiled Jacobian, parameters after the differentiation symbols
+  const auto kernel = compile(from_tuple, x, y, gm);
+  std::vector<double> buffer(4);
+  kernel.dense(std::span<double>(buffer), 0.6, 0.8, 2.0);
+  if (!check_all("compiled", std::array{buffer[0], buffer[1], buffer[2], buffer[3]}, rhs))
+    return 1;
+  std::array<double, 4> compiled_sparse{};
+  kernel.sparse(std::span(compiled_sparse), 0.6, 0.8, 2.0);
+  if (!check_all("compiled sparse", compiled_sparse, rhs))
+    return 1;
+  std::println("PASS: compiled Jacobian");
+
+  return 0;
+}
@@ -0,0 +1,147 @@
+/*
+ * test_root_solvers.cpp
+ * part of test suite for lam.symbols
+ * newton_solver and halley_solver: Kepler's equation, scalar and batched solves
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+using namespace lam::test::utils::constants;
+
+constexpr symbol E; // eccentric anomaly
+constexpr symbol e; // eccentricity
+constexpr symbol M; // mean anomaly
+constexpr symbol x;
+
+struct SinOp
+{
+  template<typename T>
+  constexpr auto operator()(const T& arg) const
+  { return std::sin(arg); }
+};
+struct CosOp
+{
+  template<typename T>
+  constexpr auto operator()(const T& arg) const
+  { return std::cos(arg); }
+};
+
+template<typename Expr>
+constexpr auto sin(const Expr& expr)
+{ return symbolic_expression<SinOp, Expr>{expr}; }
+template<typename Expr>
+constexpr auto cos(const Expr& expr)
+{ return symbolic_expression<CosOp, Expr>{expr}; }
+
+template<>
+struct lam::symbols::unary_derivative<SinOp>
+{
+  template<typename Arg>
+  constexpr auto operator()(const Arg& u) const
+  { return cos(u); }
+};
+template<>
+struct lam::symbols::unary_derivative<CosOp>
+{
+  template<typename Arg>
+  constexpr auto operator()(const Arg& u) const
+  { return -sin(u); }
+};
+
+int main()
+{
+  constexpr auto kepler = E - e * sin(E) - M;
+
+  // Test 1: scalar Newton and Halley solves agree, Halley in fewer iterations
+  const auto newton = newton_solver(kepler, E, e, M);
+  const auto halley = halley_solver(kepler, E, e, M);
+  const auto n = newton(1.0, 0.6, 1.0);
+  const auto h = halley(1.0, 0.6, 1.0);
+  if (!n.converged || !h.converged || !check_close(n.root - 0.6 * std::sin(n.root), 1.0, 1e-12) ||
+      !check_close(h.root, n.root, 1e-12) || h.iterations >= n.iterations)
+  {
+    std::println("FAIL: newton {} in {}, halley {} in {}", n.root, n.iterations, h.root, h.iterations);
+    return 1;
+  }
+  std::println("PASS: scalar solves");
+
+  // Test 2: a polynomial residual, solved at compile time
+  constexpr auto sqrt2 = newton_solver((x ^ c<2>) - c<2>, x)(1.0);
+  static_assert(sqrt2.converged && sqrt2.root * sqrt2.root - 2.0 < 1e-15 && sqrt2.root * sqrt2.root - 2.0 > -1e-15);
+  std::println("PASS: compile-time solve");
+
+  // Test 3: no root, the solve reports it
+  auto stuck = newton_solver((x ^ c<2>) + c<1>, x);
+  stuck.max_iterations = 20;
+  if (stuck(0.5).converged || stuck(0.5).iterations != 20)
+  {
+    std::println("FAIL: x^2 + 1 = 0 reported converged");
+    return 1;
+  }
+  std::println("PASS: no root");
+
+  // Test 4: batched solve, a column of mean anomalies and one eccentricity
+  constexpr std::size_t lanes = 64;
+  std::vector<double> anomalies(lanes);
+  std::vector<double> roots(lanes);
+  std::vector<char> converged(lanes);
+  for (std::size_t i = 0; i < lanes; ++i)
+  {
+    anomalies[i] = 6.0 * static_cast<double>(i) / static_cast<double>(lanes);
+    roots[i] = anomalies[i]; // the usual first guess
+  }
+  const std::size_t solved = halley.solve_batch(roots, converged, 0.3, anomalies);
+  if (solved != lanes)
+  {
+    std::println("FAIL: {} of {} lanes converged", solved, lanes);
+    return 1;
+  }
+  for (std::size_t i = 0; i < lanes; ++i)
+  {
+    const auto scalar = halley(anomalies[i], 0.3, anomalies[i]);
+    if (!converged[i] || !check_close(roots[i], scalar.root, 1e-12))
+    {
+      std::println("FAIL: lane {} gave {}, scalar solve {}", i, roots[i], scalar.root);
+      return 1;
+    }
+  }
+  std::println("PASS: batched solve");
+
+  // Test 5: lanes converge independently, a lane without a root stays unconverged
+  std::array<double, 3> guesses{1.0, 0.5, 3.0};
+  std::array<bool, 3> flags{};
+  const std::array<double, 3> constants{-2.0, 1.0, -9.0};
+  auto shifted = newton_solver((x ^ c<2>) + M, x, M);
+  shifted.max_iterations = 30;
+  if (shifted.solve_batch(guesses, flags, constants) != 2 || !flags[0] || flags[1] || !flags[2] ||
+      !check_close(guesses[0], std::sqrt(2.0), 1e-12) || !check_close(guesses[2], 3.0, 1e-12))
+  {
+    std::println("FAIL: masks ({}, {}, {}), roots ({}, {}, {})", flags[0], flags[1], flags[2], guesses[0], guesses[1],
+                 guesses[2]);
+    return 1;
+  }
+  std::println("PASS: per-lane convergence");
+
+  // Test 6: a lane where f' vanishes keeps its guess and is retired unconverged
+  std::array<double, 3> starts{1.0, 0.0, 0.0};
+  std::array<bool, 3> marks{};
+  const std::array<double, 3> squares{2.0, 2.0, 0.0};
+  auto root = newton_solver((x ^ c<2>) - M, x, M);
+  if (root.solve_batch(starts, marks, squares) != 1 || !marks[0] || marks[1] || marks[2] ||
+      !check_close(starts[0], std::sqrt(2.0), 1e-12) || starts[1] != 0.0 || starts[2] != 0.0 ||
+      root(0.0, 2.0).converged)
+  {
+    std::println("FAIL: masks ({}, {}, {}), roots ({}, {}, {})", marks[0], marks[1], marks[2], starts[0], starts[1],
+                 starts[2]);
+    return 1;
+  }
+  std::println("PASS: vanishing derivative");
+
+  return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * test_sparsity.cpp
+ * part of test suite for lam.symbols
+ * jacobian_sparsity: bitmap, CSR / CSC arrays and column coloring at compile time; colored_jacobian
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+using namespace lam::test::utils::constants;
+
+constexpr symbol x0;
+constexpr symbol x1;
+constexpr symbol x2;
+constexpr symbol x3;
+constexpr symbol x4;
+
+int main()
+{
+  // A tridiagonal system: f_i = x_(i-1) - 2 x_i + x_(i+1) + x_i^2
+  constexpr auto system = std::tuple{c<-2> * x0 + x1 + (x0 ^ c<2>), x0 - c<2> * x1 + x2 + (x1 ^ c<2>),
+                                     x1 - c<2> * x2 + x3 + (x2 ^ c<2>), x2 - c<2> * x3 + x4 + (x3 ^ c<2>),
+                                     x3 - c<2> * x4 + (x4 ^ c<2>)};
+  using pattern = decltype(sparsity_pattern(system, x0, x1, x2, x3, x4));
+
+  // Test 1: the bitmap and the compressed index arrays
+  static_assert(pattern::rows == 5 && pattern::columns == 5 && pattern::nonzeros == 13);
+  static_assert(pattern::structural(0, 1) && !pattern::structural(0, 2) && pattern::structural(4, 3));
+  static_assert(pattern::row_offsets == std::array<std::size_t, 6>{0, 2, 5, 8, 11, 13});
+  static_assert(pattern::column_indices ==
+                std::array<std::size_t, 13>{0, 1, 0, 1, 2, 1, 2, 3, 2, 3, 4, 3, 4});
+  static_assert(pattern::column_offsets == std::array<std::size_t, 6>{0, 2, 5, 8, 11, 13});
+  static_assert(pattern::row_indices ==
+                std::array<std::size_t, 13>{0, 1, 0, 1, 2, 1, 2, 3, 2, 3, 4, 3, 4});
+  std::println("PASS: CSR and CSC arrays");
+
+  // Test 2: three colors for a tridiagonal matrix, no two columns of a color share a row
+  static_assert(pattern::color_count == 3);
+  static_assert(pattern::colors == std::array<std::size_t, 5>{0, 1, 2, 0, 1});
+  for (std::size_t i = 0; i < pattern::rows; ++i)
+    for (std::size_t j = 0; j < pattern::columns; ++j)
+      for (std::size_t k = j + 1; k < pattern::columns; ++k)
+        if (pattern::structural(i, j) && pattern::structural(i, k) && pattern::colors[j] == pattern::colors[k])
+        {
+          std::println("FAIL: columns {} and {} share row {} and color {}", j, k, i, pattern::colors[j]);
+          return 1;
+        }
+  std::println("PASS: column coloring");
+
+  // Test 3: a symbol no output contains is an empty column of its own color
+  constexpr symbol unused;
+  using padded = decltype(sparsity_pattern(system, x0, x1, x2, x3, x4, unused));
+  static_assert(padded::column_offsets[6] - padded::column_offsets[5] == 0 && padded::colors[5] == 0);
+  std::println("PASS: empty columns");
+
+  // Test 4: the colored forward mode Jacobian agrees with jacobian(), in CSR order
+  const auto kernel = compile(std::apply([](const auto&... f) { return formula_bundle{f...}; }, system),
+                              x0, x1, x2, x3, x4);
+  const std::array point{0.3, -1.2, 0.8, 2.5, -0.4};
+  std::array<double, pattern::nonzeros> values{};
+  const auto outputs = colored_jacobian(kernel, point, std::span(values));
+
+  std::array<double, pattern::nonzeros> expected{};
+  compile(jacobian(system, x0, x1, x2, x3, x4), x0, x1, x2, x3, x4)
+    .sparse(std::span(expected), 0.3, -1.2, 0.8, 2.5, -0.4);
+  for (std::size_t k = 0; k < pattern::nonzeros; ++k)
+  {
+    if (!check_close(values[k], expected[k], 1e-12))
+    {
+      std::println("FAIL: nonzero {} is {}, expected {}", k, values[k], expected[k]);
+      return 1;
+    }
+  }
+  if (!check_close(outputs[2], -1.2 - 1.6 + 2.5 + 0.64, 1e-12))
+  {
+    std::println("FAIL: output 2 is {}", outputs[2]);
+    return 1;
+  }
+  std::println("PASS: colored_jacobian");
+
+  return 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * test_stencils.cpp
+ * part of test suite for lam.symbols
+ * stencil<D, Offsets...>: exact weights and accuracy at compile time, emitted expressions, grid values
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+using namespace lam::test::utils::constants;
+
+constexpr symbol h;
+constexpr symbol k;
+constexpr symbol um;
+constexpr symbol u0;
+constexpr symbol up;
+
+int main()
+{
+  // Test 1: classic weights, integers over a common denominator
+  using second = central_stencil_t<2, 2>;
+  static_assert(second::offsets == std::array{-1, 0, 1});
+  static_assert(second::numerators == std::array<std::int64_t, 3>{1, -2, 1} && second::denominator == 1);
+  using first4 = central_stencil_t<1, 4>;
+  static_assert(first4::numerators == std::array<std::int64_t, 5>{1, -8, 0, 8, -1} && first4::denominator == 12);
+  using forward = forward_stencil_t<1, 2>;
+  static_assert(forward::numerators == std::array<std::int64_t, 3>{-3, 4, -1} && forward::denominator == 2);
+  using backward = backward_stencil_t<1, 2>;
+  static_assert(backward::numerators == std::array<std::int64_t, 3>{1, -4, 3} && backward::denominator == 2);
+  using fourth = central_stencil_t<4, 2>;
+  static_assert(fourth::numerators == std::array<std::int64_t, 5>{1, -4, 6, -4, 1});
+  std::println("PASS: weights");
+
+  // Test 2: accuracy, one order more for a symmetric stencil of an even derivative
+  static_assert(second::accuracy == 2 && first4::accuracy == 4 && forward::accuracy == 2);
+  static_assert(central_stencil_t<2, 6>::accuracy == 6 && stencil<1, 0, 1>::accuracy == 1);
+  static_assert(stencil<2, -2, 0, 3>::accuracy == 1);
+  std::println("PASS: accuracy");
+
+  // Test 3: the emitted expression, zero weights and unit factors folded away
+  constexpr auto laplacian = second::apply(h, um, u0, up);
+  static_assert(std::is_same_v<std::remove_cvref_t<decltype(laplacian)>,
+                               std::remove_cvref_t<decltype((um + c<-2> * u0 + up) / (h ^ c<2>))>>);
+  constexpr auto slope = first4::on_grid(h);
+  static_assert(!contains_symbol_v<std::remove_cvref_t<decltype(slope)>, grid_value<0>>);
+  std::println("PASS: emitted expressions");
+
+  // Test 4: exact on polynomials of low degree, fused with a coefficient expression
+  const auto cubic = [](double x) { return 2.0 * x * x * x - x * x + 5.0; };
+  const auto diffusion = compile(k * second::apply(h, um, u0, up), k, h, um, u0, up);
+  const double x = 0.7;
+  const double step = 0.25;
+  const double exact = 0.5 * (12.0 * x - 2.0);
+  if (!check_close(diffusion(0.5, step, cubic(x - step), cubic(x), cubic(x + step)), exact, 1e-12))
+  {
+    std::println("FAIL: k u'' gave {}, expected {}", diffusion(0.5, step, cubic(x - step), cubic(x), cubic(x + step)),
+                 exact);
+    return 1;
+  }
+  const double derivative = first4::apply(step, cubic(x - 2 * step), cubic(x - step), cubic(x), cubic(x + step),
+                                          cubic(x + 2 * step));
+  if (!check_close(derivative, 6.0 * x * x - 2.0 * x, 1e-12))
+  {
+    std::println("FAIL: u' gave {}", derivative);
+    return 1;
+  }
+  std::println("PASS: exact on polynomials");
+
+  // Test 5: a 2D Laplacian over grid values, the centre shared by both axes
+  constexpr auto laplacian2 = second::on_grid<0>(h) + second::on_grid<1>(h);
+  const auto field = [](double px, double py) { return px * px * py + 3.0 * py * py; };
+  const double px = 0.4;
+  const double py = -1.1;
+  const double value = laplacian2(h = step, grid_value<-1, 0>{} = field(px - step, py),
+                                  grid_value<1, 0>{} = field(px + step, py), grid_value<0>{} = field(px, py),
+                                  grid_value<-1, 1>{} = field(px, py - step), grid_value<1, 1>{} = field(px, py + step));
+  if (!check_close(value, 2.0 * py + 6.0, 1e-12))
+  {
+    std::println("FAIL: 2D Laplacian gave {}", value);
+    return 1;
+  }
+  std::println("PASS: grid values");
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * test_taylor.cpp
+ * part of test suite for lam.symbols
+ * taylor(expr, x, x0, c<n>): coefficients folded at compile time, runtime points, polynomial passes
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+using namespace lam::test::utils::constants;
+
+constexpr symbol x;
+constexpr symbol y;
+constexpr symbol u;
+
+// A custom unary operator, constexpr with the builtin
+struct ExpOp
+{
+  template<typename T>
+  constexpr auto operator()(const T& arg) const
+  { return std::exp(arg); }
+};
+
+template<>
+struct lam::symbols::unary_derivative<ExpOp>
+{
+  template<typename Arg>
+  constexpr auto operator()(const Arg& u) const
+  { return symbolic_expression<ExpOp, Arg>{u}; }
+};
+
+template<typename Expr>
+constexpr auto exp(const Expr& expr)
+{ return symbolic_expression<ExpOp, Expr>{expr}; }
+
+int main()
+{
+  // Test 1: a polynomial is its own expansion, every coefficient a constant_symbol
+  constexpr auto cubic = c<5> + c<2> * x + (x ^ c<3>);
+  constexpr auto same = taylor(cubic, x, c<1>, c<3>);
+  static_assert(std::is_same_v<std::remove_cvref_t<decltype(same)>, std::remove_cvref_t<decltype(cubic)>>);
+  // truncated about 1: 8 + 5 (x - 1) + 3 (x - 1)^2 = 3 x^2 - x + 6
+  constexpr auto quadratic = taylor(cubic, x, c<1>, c<2>);
+  static_assert(std::is_same_v<std::remove_cvref_t<decltype(quadratic)>,
+                               std::remove_cvref_t<decltype(c<6> + c<-1> * x + c<3> * (x ^ c<2>))>>);
+  std::println("PASS: polynomials");
+
+  // Test 2: the coefficients of exp about 0 are exact reciprocals of factorials
+  constexpr auto e4 = taylor(exp(x), x, c<0>, c<4>);
+  static_assert(std::is_same_v<std::remove_cvref_t<decltype(e4)>,
+                               std::remove_cvref_t<decltype(c<1> + x + c<rational{1, 2}> * (x ^ c<2>) +
+                                                            c<rational{1, 6}> * (x ^ c<3>) +
+                                                            c<rational{1, 24}> * (x ^ c<4>))>>);
+  if (!check_close(e4(x = 0.1), std::exp(0.1), 1e-7))
+  {
+    std::println("FAIL: exp order 4 at 0.1 is {}", e4(x = 0.1));
+    return 1;
+  }
+  std::println("PASS: constant coefficients");
+
+  // Test 3: other symbols stay in the coefficients
+  const auto scaled = taylor(y * exp(c<2> * x), x, c<0>, c<2>);
+  if (!check_close(scaled(x = 0.01, y = 3.0), 3.0 * (1.0 + 0.02 + 0.0002), 1e-12))
+  {
+    std::println("FAIL: y exp(2 x) gave {}", scaled(x = 0.01, y = 3.0));
+    return 1;
+  }
+  std::println("PASS: symbolic coefficients");
+
+  // Test 4: a runtime point, and the shifted form
+  const double x0 = 0.7;
+  const auto runtime = taylor(exp(x), x, x0, c<6>);
+  const auto shifted = taylor(exp(x)(x = u + c<0.5>), u, c<0>, c<6>);
+  if (!check_close(runtime(x = 0.75), std::exp(0.75), 1e-10) || !check_close(shifted(u = 0.25), std::exp(0.75), 1e-6))
+  {
+    std::println("FAIL: runtime point {}, shifted {}", runtime(x = 0.75), shifted(u = 0.25));
+    return 1;
+  }
+  std::println("PASS: runtime point");
+
+  // Test 5: the result is a polynomial the polynomial passes recognize
+  const auto nested = horner(e4, x);
+  static_assert(is_symbolic_expression<std::remove_cvref_t<decltype(nested)>>::value);
+  static_assert(!std::is_same_v<decltype(nested), decltype(e4)>);
+  if (!check_close(nested(x = 0.3), e4(x = 0.3), 1e-15))
+  {
+    std::println("FAIL: horner form {} vs {}", nested(x = 0.3), e4(x = 0.3));
+    return 1;
+  }
+  std::println("PASS: horner");
+
+  return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * test_numeric_value.cpp
+ * part of test suite for lam.symbols
+ * Non-builtin numeric types folding through the simplifier (numeric_value)
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+
+// A minimal 4-lane pack standing in for a SIMD type
+struct pack4
+{
+  std::array<double, 4> lanes{};
+
+  constexpr pack4() = default;
+  constexpr pack4(double v) : lanes{v, v, v, v} {}
+  constexpr pack4(double a, double b, double c, double d) : lanes{a, b, c, d} {}
+
+  friend constexpr pack4 operator+(const pack4& l, const pack4& r)
+  { return {l.lanes[0] + r.lanes[0], l.lanes[1] + r.lanes[1], l.lanes[2] + r.lanes[2], l.lanes[3] + r.lanes[3]}; }
+  friend constexpr pack4 operator-(const pack4& l, const pack4& r)
+  { return {l.lanes[0] - r.lanes[0], l.lanes[1] - r.lanes[1], l.lanes[2] - r.lanes[2], l.lanes[3] - r.lanes[3]}; }
+  friend constexpr pack4 operator*(const pack4& l, const pack4& r)
+  { return {l.lanes[0] * r.lanes[0], l.lanes[1] * r.lanes[1], l.lanes[2] * r.lanes[2], l.lanes[3] * r.lanes[3]}; }
+  friend constexpr pack4 operator/(const pack4& l, const pack4& r)
+  { return {l.lanes[0] / r.lanes[0], l.lanes[1] / r.lanes[1], l.lanes[2] / r.lanes[2], l.lanes[3] / r.lanes[3]}; }
+  friend constexpr pack4 operator-(const pack4& p) { return {-p.lanes[0], -p.lanes[1], -p.lanes[2], -p.lanes[3]}; }
+  // found by argument dependent lookup from the simplifier
+  friend pack4 pow(const pack4& p, int e)
+  {
+    return {std::pow(p.lanes[0], e), std::pow(p.lanes[1], e), std::pow(p.lanes[2], e), std::pow(p.lanes[3], e)};
+  }
+};
+
+// Opt in: pack4 folds like a builtin number
+template<>
+struct lam::symbols::is_numeric_value<pack4> : std::true_type
+{};
+
+int main()
+{
+  constexpr symbol x;
+  constexpr symbol y;
+
+  static_assert(numeric_value<double> && numeric_value<std::complex<float>> && numeric_value<pack4>);
+  static_assert(!numeric_value<decltype(x)>);
+
+  // Test 1: std::complex binders evaluate to a value, including mixed int/complex folding
+  constexpr auto expr = x * y - y + 2;
+  using complex = std::complex<double>;
+  auto c = expr(x = complex{1.0, 2.0}, y = complex{0.5, -1.0});
+  static_assert(std::is_same_v<decltype(c), complex>, "complex substitution should fold to std::complex");
+  complex c_expected = complex{1.0, 2.0} * complex{0.5, -1.0} - complex{0.5, -1.0} + 2.0;
+  if (std::abs(c - c_expected) > 1e-12)
+  {
+    std::println("FAIL: complex evaluation gave ({}, {})", c.real(), c.imag());
+    return 1;
+  }
+  std::println("PASS: complex substitution folded to a value");
+
+  // Test 2: a custom pack type, evaluated lane by lane in one call
+  pack4 xs{1.0, 2.0, 3.0, 4.0};
+  pack4 ys{0.5, 0.5, 0.5, 0.5};
+  auto p = expr(x = xs, y = ys);
+  static_assert(std::is_same_v<decltype(p), pack4>, "pack substitution should fold to pack4");
+  for (std::size_t lane = 0; lane < 4; ++lane)
+  {
+    double expected = expr(x = xs.lanes[lane], y = ys.lanes[lane]);
+    if (!check_close(p.lanes[lane], expected))
+    {
+      std::println("FAIL: lane {} evaluated to {}, expected {}", lane, p.lanes[lane], expected);
+      return 1;
+    }
+  }
+  std::println("PASS: pack4 substitution folded lane by lane");
+
+  // Test 3: powers, negation and division go through the same path
+  auto q = (-(x * x) / y)(x = xs, y = ys);
+  if (!check_close(q.lanes[3], -32.0))
+  {
+    std::println("FAIL: -(x*x)/y gave {} in lane 3", q.lanes[3]);
+    return 1;
+  }
+
+  // Test 4: partial substitution keeps the numeric leaf
+  auto partial = expr(x = complex{1.0, 1.0});
+  static_assert(is_symbolic_v<decltype(partial)>, "y is unbound, result should stay symbolic");
+  auto completed = partial(y = complex{2.0, 0.0});
+  if (std::abs(completed - (complex{1.0, 1.0} * 2.0 - 2.0 + 2.0)) > 1e-12)
+  {
+    std::println("FAIL: completed partial gave ({}, {})", completed.real(), completed.imag());
+    return 1;
+  }
+
+  std::println("SUCCESS");
+  return 0;
+}
@@ -22,13 +22,12 @@ int main()
 
   // If strict type-based equality is used blindly, f1 and f2 might be considered "equal" types,
   // and thus f1 - f2 might simplify to 0.
-  // Correct behavior: should return a symbolic expression (or -1.0 if we had advanced simplification, but definitely
-  // not 0).
+  // Correct behavior: the x terms cancel and the values fold, -1.0, but definitely not 0.
   auto diff = f1 - f2;
+  static_assert(std::is_same_v<decltype(diff), double>, "(x+1.0) - (x+2.0) should fold to a value");
 
-  // Evaluate to check correctness
-  double res = diff(x = 10.0);
-  // (10+1) - (10+2) = 11 - 12 = -1
+  double res = diff;
+  // (x+1) - (x+2) = -1
 
   if (std::abs(res - (-1.0)) < 1e-9)
   {
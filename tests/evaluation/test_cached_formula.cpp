@@ -0,0 +1,94 @@
+/*
+ * test_cached_formula.cpp
+ * part of test suite for lam.symbols
+ * cache(): dependency masks, slots, and recomputation of changed subtrees only
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+
+constexpr symbol x;
+constexpr symbol y;
+constexpr symbol gm;
+constexpr symbol m;
+
+// Identity operator counting its evaluations
+template<int Tag>
+struct counted
+{
+  static inline int calls = 0;
+
+  template<typename T>
+  constexpr auto operator()(const T& value) const
+  {
+    ++calls;
+    return value;
+  }
+};
+
+template<int Tag, typename Expression>
+constexpr auto count(const Expression& expr)
+{ return symbolic_expression<counted<Tag>, Expression>(expr); }
+
+int main()
+{
+  // Test 1: dependency masks follow the symbol order given
+  using symbols = std::tuple<decltype(x), decltype(y), decltype(gm)>;
+  static_assert(dependency_mask_v<symbols, decltype(x * y)> == 0b011);
+  static_assert(dependency_mask_v<symbols, decltype(gm + x)> == 0b101);
+  static_assert(dependency_mask_v<symbols, decltype(m)> == 0);
+  std::println("PASS: dependency masks");
+
+  // Test 2: only subtrees depending on fewer symbols than their parent get a slot
+  static_assert(decltype(cache((x / y) * (x - y), x, y))::slot_count == 1, "one slot, the root");
+  static_assert(decltype(cache((gm / m) * (x / y), x, y, gm, m))::slot_count == 3, "gm / m, x / y and the root");
+  static_assert(decltype(cache((gm + m) * (x + y), x, y, gm, m))::slot_count == 1, "sums of leaves stay inline");
+  std::println("PASS: slots");
+
+  // Test 3: a changed input recomputes the subtrees reading it, and no other
+  const auto expr = count<0>(gm * m) * x + count<1>(x * y);
+  const auto reference = compile(expr, x, y, gm, m);
+  auto f = cache(expr, x, y, gm, m);
+
+  const auto check = [&](double xv, double yv, double gmv, double mv, int calls0, int calls1) {
+    const double expected = reference(xv, yv, gmv, mv);
+    counted<0>::calls -= 1;
+    counted<1>::calls -= 1;
+    const double actual = f(xv, yv, gmv, mv);
+    if (!check_close(actual, expected) || counted<0>::calls != calls0 || counted<1>::calls != calls1)
+    {
+      std::println("FAIL: f({}, {}, {}, {}) = {}, expected {}, recomputed ({}, {})", xv, yv, gmv, mv, actual,
+                   expected, counted<0>::calls, counted<1>::calls);
+      return false;
+    }
+    return true;
+  };
+  // the reference adds one call to each counter, taken back before the cached call
+  if (!check(1.0, 2.0, 3.0, 4.0, 1, 1) || !check(1.0, 2.0, 3.0, 4.0, 1, 1) || !check(5.0, 2.0, 3.0, 4.0, 1, 2) ||
+      !check(5.0, 2.0, 0.5, 4.0, 2, 2) || !check(5.0, -1.0, 0.5, 4.0, 2, 3))
+    return 1;
+  std::println("PASS: changed subtrees only");
+
+  // Test 4: reset() recomputes everything on the next call
+  f.reset();
+  if (!check(5.0, -1.0, 0.5, 4.0, 3, 4))
+    return 1;
+  std::println("PASS: reset");
+
+  // Test 5: a subtree free of every symbol is computed on the first call only
+  auto g = cache(count<2>(constant_symbol<3>{}) * x, x);
+  if (g(1.0) != 3.0 || g(2.0) != 6.0 || g(4.0) != 12.0 || counted<2>::calls != 1)
+  {
+    std::println("FAIL: constant subtree evaluated {} times", counted<2>::calls);
+    return 1;
+  }
+  std::println("PASS: constant subtrees");
+
+  return 0;
+}
@@ -0,0 +1,86 @@
+/*
+ * test_compile.cpp
+ * part of test suite for lam.symbols
+ * Positional compiled kernels: compile(expr, x, y, z)
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+
+int main()
+{
+  constexpr symbol x;
+  constexpr symbol y;
+  constexpr symbol z;
+
+  constexpr auto expr = (x + y) * z - y;
+
+  // Test 1: positional call matches the binder call
+  constexpr auto f = compile(expr, x, y, z);
+  static_assert(f.arity == 3);
+  static_assert(f(1, 2, 3) == expr(x = 1, y = 2, z = 3), "positional and binder calls should agree");
+
+  double positional = f(1.5, 2.0, 3.0);
+  double bound = expr(x = 1.5, y = 2.0, z = 3.0);
+  std::println("f(1.5, 2.0, 3.0) = {} (binder call: {})", positional, bound);
+  if (!check_close(positional, bound))
+  {
+    std::println("FAIL: positional call disagrees with binder call");
+    return 1;
+  }
+
+  // Test 2: symbol order is the compile order, not the expression order
+  constexpr auto g = compile(x - y, y, x);
+  static_assert(g(1, 10) == 9, "g(y = 1, x = 10) should be 9");
+
+  // Test 3: std::array and std::span overloads
+  constexpr std::array<double, 3> point{1.5, 2.0, 3.0};
+  double from_array = f(point);
+  double from_span = f(std::span(point));
+  std::vector<double> dynamic{1.5, 2.0, 3.0};
+  double from_dynamic_span = f(std::span<const double>(dynamic));
+  if (!check_close(from_array, bound) || !check_close(from_span, bound) || !check_close(from_dynamic_span, bound))
+  {
+    std::println("FAIL: array/span calls disagree ({}, {}, {})", from_array, from_span, from_dynamic_span);
+    return 1;
+  }
+  bool rejected_short_span = false;
+  try
+  {
+    (void)f(std::span<const double>(dynamic).first(2));
+  }
+  catch (const std::out_of_range&)
+  {
+    rejected_short_span = true;
+  }
+  if (!rejected_short_span)
+  {
+    std::println("FAIL: a dynamic span shorter than the symbol list was accepted");
+    return 1;
+  }
+
+  // Test 4: symbols left out of the compile list stay symbolic
+  constexpr auto h = compile(expr, x, y);
+  auto partial = h(1.5, 2.0);
+  static_assert(is_symbolic_v<decltype(partial)>, "z is unbound, result should be symbolic");
+  double completed = partial(z = 3.0);
+  if (!check_close(completed, bound))
+  {
+    std::println("FAIL: partial compiled result evaluated to {}", completed);
+    return 1;
+  }
+
+  // Test 5: formulas compile too
+  constexpr formula fm = x * y;
+  constexpr auto k = compile(fm, x, y);
+  static_assert(k(3, 4) == 12);
+
+  std::println("SUCCESS");
+  return 0;
+}
@@ -0,0 +1,86 @@
+/*
+ * test_evaluate_batch.cpp
+ * part of test suite for lam.symbols
+ * Batched structure-of-arrays evaluation: evaluate_batch(expr, out, x = xs, ...)
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+
+constexpr symbol x;
+constexpr symbol y;
+constexpr symbol gm;
+
+// evaluate_batch is constexpr: a whole batch can be produced at compile time
+consteval std::array<double, 4> compile_time_batch()
+{
+  constexpr std::array<double, 4> xs{1.0, 2.0, 3.0, 4.0};
+  std::array<double, 4> out{};
+  evaluate_batch(x * x + 1.0, out, x = xs);
+  return out;
+}
+
+int main()
+{
+  constexpr std::size_t n = 1000;
+  std::vector<double> xs(n), ys(n), out(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    xs[i] = 0.5 + static_cast<double>(i) * 0.01;
+    ys[i] = 1.0 - static_cast<double>(i) * 0.002;
+  }
+
+  // Test 1: columns and a broadcast scalar
+  constexpr auto expr = -gm * x / (x * x + y * y);
+  evaluate_batch(expr, out, x = std::span(xs), y = ys, gm = 2.5);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    double expected = expr(gm = 2.5, x = xs[i], y = ys[i]);
+    if (!check_close(out[i], expected))
+    {
+      std::println("FAIL: point {} evaluated to {}, expected {}", i, out[i], expected);
+      return 1;
+    }
+  }
+  std::println("PASS: {} points match the scalar evaluation", n);
+
+  // Test 2: compiled kernel with positional inputs, float output
+  constexpr auto kernel = compile(x * y, x, y);
+  std::vector<float> narrow(n);
+  evaluate_batch(kernel, narrow, xs, 2.0);
+  if (!check_close(static_cast<double>(narrow[10]), xs[10] * 2.0, 1e-5))
+  {
+    std::println("FAIL: compiled batch evaluated to {}", narrow[10]);
+    return 1;
+  }
+
+  // Test 3: in place update (output aliases an input column)
+  std::vector<double> state = xs;
+  evaluate_batch(x + x, state, x = state);
+  if (!check_close(state[n - 1], 2.0 * xs[n - 1]))
+  {
+    std::println("FAIL: in place batch evaluated to {}", state[n - 1]);
+    return 1;
+  }
+
+  // Test 4: formulas and compile time batches
+  constexpr formula f = x * x + 1.0;
+  std::array<double, 4> small{};
+  evaluate_batch(f, small, x = std::array{1.0, 2.0, 3.0, 4.0});
+  constexpr auto ct = compile_time_batch();
+  static_assert(ct[3] == 17.0, "compile time batch should evaluate 4*4 + 1");
+  if (small != ct)
+  {
+    std::println("FAIL: runtime and compile time batches differ");
+    return 1;
+  }
+
+  std::println("SUCCESS");
+  return 0;
+}
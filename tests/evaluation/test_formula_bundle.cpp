@@ -0,0 +1,129 @@
+/*
+ * test_formula_bundle.cpp
+ * part of test suite for lam.symbols
+ * Multi-output bundles: shared subtrees are detected by type and evaluated once
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+
+// A stateless square root that counts how often it runs
+inline int sqrt_calls = 0;
+struct CountedSqrt
+{
+  template<typename T>
+  constexpr auto operator()(const T& arg) const
+  {
+    if !consteval
+    {
+      ++sqrt_calls;
+    }
+    return std::sqrt(arg);
+  }
+};
+
+template<typename Expr>
+constexpr auto counted_sqrt(const Expr& expr)
+{ return symbolic_expression<CountedSqrt, Expr>{expr}; }
+
+constexpr symbol x;
+constexpr symbol y;
+constexpr symbol vx;
+constexpr symbol vy;
+constexpr symbol gm;
+
+int main()
+{
+  constexpr auto r2 = x * x + y * y;
+  constexpr auto r = counted_sqrt(r2);
+  constexpr auto ax = -gm * x / (r2 * r);
+  constexpr auto ay = -gm * y / (r2 * r);
+  constexpr auto energy = 0.5 * (vx * vx + vy * vy) - gm / r;
+
+  // Test 1: detection. -gm and r2 * r (ax, ay), r (r2 * r, energy) and r2 (r2 * r, r) are
+  // shared; the r2 of ax is not counted again, it only appears inside the shared r2 * r
+  constexpr formula_bundle bundle{ax, ay, energy};
+  static_assert(decltype(bundle)::size == 3);
+  static_assert(decltype(bundle)::shared_count == 4, "-gm, r2, sqrt(r2) and r2 * sqrt(r2) should be shared");
+  static_assert(formula_bundle{x + y, x * y}.shared_count == 0, "nothing shared between unrelated outputs");
+  static_assert(formula_bundle{(x + y) * gm, (x + y) * vx}.shared_count == 1);
+  // subtrees holding runtime data (the 0.5 literal) are never shared: only
+  // vx^2 + vy^2 and -(gm / r) are, r and r2 stay inside the shared -(gm / r)
+  static_assert(formula_bundle{energy, energy}.shared_count == 2);
+  std::println("PASS: shared subtrees detected by type");
+
+  // Test 2: values match separate evaluation, each shared subtree runs once
+  sqrt_calls = 0;
+  auto [bax, bay, benergy] = bundle(x = 3.0, y = 4.0, vx = 1.0, vy = 2.0, gm = 2.0);
+  if (sqrt_calls != 1)
+  {
+    std::println("FAIL: sqrt evaluated {} times per bundle call, expected 1", sqrt_calls);
+    return 1;
+  }
+  const double eax = ax(x = 3.0, y = 4.0, gm = 2.0);
+  const double eay = ay(x = 3.0, y = 4.0, gm = 2.0);
+  const double eenergy = energy(x = 3.0, y = 4.0, vx = 1.0, vy = 2.0, gm = 2.0);
+  if (!check_close(bax, eax) || !check_close(bay, eay) || !check_close(benergy, eenergy))
+  {
+    std::println("FAIL: bundle gave ({}, {}, {}), expected ({}, {}, {})", bax, bay, benergy, eax, eay, eenergy);
+    return 1;
+  }
+  std::println("PASS: bundle outputs match, sqrt evaluated once");
+
+  // Test 3: constexpr evaluation and compiled positional calls
+  constexpr auto sums = formula_bundle{(x + y) * gm, (x + y) * vx}(x = 1, y = 2, gm = 3, vx = 4);
+  static_assert(std::get<0>(sums) == 9 && std::get<1>(sums) == 12);
+  constexpr auto kernel = compile(bundle, x, y, vx, vy, gm);
+  sqrt_calls = 0;
+  const auto [kax, kay, kenergy] = kernel(3.0, 4.0, 1.0, 2.0, 2.0);
+  if (sqrt_calls != 1 || !check_close(kax, eax) || !check_close(kay, eay) || !check_close(kenergy, eenergy))
+  {
+    std::println("FAIL: compiled bundle gave ({}, {}, {}) with {} sqrt calls", kax, kay, kenergy, sqrt_calls);
+    return 1;
+  }
+  std::println("PASS: compiled bundle matches");
+
+  // Test 4: partial evaluation leaves the unbound symbols in place
+  const auto [pax, pay, penergy] = bundle(x = 3.0, y = 4.0);
+  if (!check_close(pax(gm = 2.0), eax) || !check_close(penergy(vx = 1.0, vy = 2.0, gm = 2.0), eenergy))
+  {
+    std::println("FAIL: partially evaluated bundle does not finish to the full value");
+    return 1;
+  }
+  std::println("PASS: partial evaluation");
+
+  // Test 5: batches write every output column
+  constexpr std::size_t n = 257;
+  std::vector<double> xs(n), ys(n), out_ax(n), out_ay(n), out_energy(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    xs[i] = 1.0 + static_cast<double>(i) * 0.01;
+    ys[i] = 2.0 - static_cast<double>(i) * 0.005;
+  }
+  sqrt_calls = 0;
+  evaluate_batch(bundle, std::tie(out_ax, out_ay, out_energy), x = xs, y = ys, vx = 0.5, vy = 0.25, gm = 1.5);
+  if (sqrt_calls != static_cast<int>(n))
+  {
+    std::println("FAIL: {} sqrt calls for {} points", sqrt_calls, n);
+    return 1;
+  }
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    if (!check_close(out_ax[i], ax(x = xs[i], y = ys[i], gm = 1.5)) ||
+        !check_close(out_ay[i], ay(x = xs[i], y = ys[i], gm = 1.5)) ||
+        !check_close(out_energy[i], energy(x = xs[i], y = ys[i], vx = 0.5, vy = 0.25, gm = 1.5)))
+    {
+      std::println("FAIL: batch point {} differs from scalar evaluation", i);
+      return 1;
+    }
+  }
+  std::println("PASS: {} points written to 3 outputs", n);
+
+  return 0;
+}
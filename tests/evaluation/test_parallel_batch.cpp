@@ -0,0 +1,74 @@
+/*
+ * test_parallel_batch.cpp
+ * part of test suite for lam.symbols
+ * Policy-driven batch evaluation on the work-stealing thread pool
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+
+constexpr symbol x;
+constexpr symbol y;
+constexpr symbol gm;
+
+template<typename Policy>
+bool matches_reference(const Policy& policy, const char* name, const std::vector<double>& xs,
+                       const std::vector<double>& ys, const std::vector<double>& reference)
+{
+  std::vector<double> out(xs.size(), -1.0);
+  evaluate_batch(policy, -gm * x / (x * x + y * y), out, x = xs, y = ys, gm = 1.5);
+  for (std::size_t i = 0; i < out.size(); ++i)
+  {
+    if (!check_close(out[i], reference[i]))
+    {
+      std::println("FAIL: {} point {} evaluated to {}, expected {}", name, i, out[i], reference[i]);
+      return false;
+    }
+  }
+  std::println("PASS: {} matches the reference on {} points", name, out.size());
+  return true;
+}
+
+int main()
+{
+  constexpr std::size_t n = 100'003; // not a multiple of any chunk size
+  std::vector<double> xs(n), ys(n), reference(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    xs[i] = 1.0 + static_cast<double>(i % 997) * 1e-3;
+    ys[i] = -0.5 + static_cast<double>(i % 991) * 1e-3;
+  }
+  evaluate_batch(-gm * x / (x * x + y * y), reference, x = xs, y = ys, gm = 1.5);
+
+  thread_pool pool(4);
+  bool ok = true;
+  ok &= matches_reference(execution::seq, "seq", xs, ys, reference);
+  ok &= matches_reference(execution::unseq, "unseq", xs, ys, reference);
+  ok &= matches_reference(execution::par, "par (shared pool)", xs, ys, reference);
+  ok &= matches_reference(execution::par.on(pool), "par (4 threads)", xs, ys, reference);
+  ok &= matches_reference(execution::par_unseq.on(pool).with_chunk_size(1000), "par_unseq (chunks of 1000)", xs, ys,
+                          reference);
+
+  // The pool is reusable: many small submissions in a row
+  std::vector<double> out(257);
+  for (int round = 0; round < 200; ++round)
+    evaluate_batch(execution::par.on(pool).with_chunk_size(16), compile(x + 1.0, x), out, xs);
+  ok &= check_close(out[256], xs[256] + 1.0);
+
+  // Raw parallel_for: every index visited exactly once
+  std::vector<std::atomic<int>> visits(10'000);
+  pool.parallel_for(visits.size(), 37, [&](std::size_t first, std::size_t last) {
+    for (std::size_t i = first; i < last; ++i)
+      visits[i].fetch_add(1, std::memory_order_relaxed);
+  });
+  ok &= std::ranges::all_of(visits, [](const std::atomic<int>& v) { return v.load() == 1; });
+
+  std::println(ok ? "SUCCESS" : "FAILURE");
+  return ok ? 0 : 1;
+}
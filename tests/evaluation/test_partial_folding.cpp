@@ -0,0 +1,57 @@
+/*
+ * test_partial_folding.cpp
+ * part of test suite for lam.symbols
+ * Partial substitution: bound subtrees fold to one value, unbound subtrees keep their type
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+using namespace lam::test::utils::constants;
+
+constexpr ordered_symbol<0> x;
+constexpr ordered_symbol<1> y;
+constexpr ordered_symbol<2> gm;
+constexpr ordered_symbol<3> m;
+
+int main()
+{
+  // Test 1: the bound factors of a product fold to one leading value
+  constexpr auto product = x * gm * m * y;
+  constexpr auto scaled = product(gm = 1.5, m = 4.0);
+  static_assert(same_v<decltype(scaled), decltype(1.0 * x * y)>);
+  static_assert(std::get<0>(scaled.terms) == 6.0);
+  std::println("PASS: one value per product");
+
+  // Test 2: in a sum, bound terms fold together and like terms merge their coefficients
+  constexpr auto sum = c<2> * x + gm * m + x * gm + y;
+  constexpr auto partial = sum(gm = 2.0, m = 3.0);
+  static_assert(std::tuple_size_v<decltype(partial.terms)> == 3);
+  static_assert(std::get<0>(partial.terms) == 6.0);
+  if (!check_close(partial(x = 1.5, y = -2.0), sum(x = 1.5, y = -2.0, gm = 2.0, m = 3.0)))
+  {
+    std::println("FAIL: partial sum gave {}", partial(x = 1.5, y = -2.0));
+    return 1;
+  }
+  std::println("PASS: one value per sum");
+
+  // Test 3: a subtree binding none of its symbols keeps its type, constant_symbols included
+  constexpr auto mixed = c<3> * (x ^ c<2>) * y + gm;
+  constexpr auto kept = mixed(gm = 1.0);
+  static_assert(same_v<decltype(std::get<1>(kept.terms)), decltype(c<3> * (x ^ c<2>) * y)>);
+  static_assert(same_v<decltype(mixed(m = 1.0)), decltype(mixed)>);
+  std::println("PASS: unbound subtrees");
+
+  // Test 4: a constant_symbol meeting a bound value folds with it
+  static_assert(same_v<decltype(c<2> * 3.0), double> && c<2> * 3.0 == 6.0);
+  static_assert((c<2> * gm * x)(gm = 0.25)(x = 4.0) == 2.0);
+  static_assert((x / c<4> + gm)(gm = 1.0)(x = 2.0) == 1.5);
+  std::println("PASS: constants and values");
+
+  return 0;
+}
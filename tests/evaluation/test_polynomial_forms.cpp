@@ -0,0 +1,90 @@
+/*
+ * test_polynomial_forms.cpp
+ * part of test suite for lam.symbols
+ * horner(), estrin() and polynomial_form(): sums of c * x^k evaluated as polynomials
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+using namespace lam::test::utils::constants;
+
+constexpr symbol x;
+constexpr symbol y;
+constexpr symbol a;
+constexpr symbol b;
+
+int main()
+{
+  // Test 1: recognition. Degrees, coefficients free of x, and what is not a monomial
+  static_assert(monomial_degree_v<decltype(x), decltype(x ^ c<3>)> == 3);
+  static_assert(monomial_degree_v<decltype(x), decltype(a * (x ^ c<2>))> == 2);
+  static_assert(monomial_degree_v<decltype(x), decltype(a * b)> == 0);
+  static_assert(monomial_degree_v<decltype(x), decltype(x ^ c<-1>)> == not_a_monomial);
+  static_assert(monomial_degree_v<decltype(x), decltype(x / a)> == not_a_monomial);
+  std::println("PASS: monomial recognition");
+
+  // Test 2: a cubic with constant coefficients, gaps included
+  constexpr auto cubic = c<2> * (x ^ c<3>) - c<5> * x + c<7>;
+  constexpr auto cubic_horner = horner(cubic, x);
+  using cubic_t = std::remove_cvref_t<decltype(cubic_horner)>;
+  static_assert(std::is_same_v<expr_op_t<cubic_t>, polynomial_evaluation<polynomial_scheme::horner, 0, 1, 3>>);
+  static_assert(cubic_horner(x = 2) == cubic(x = 2), "exact for integer coefficients");
+  static_assert(estrin(cubic, x)(x = -3.0) == cubic(x = -3.0));
+  std::println("PASS: cubic in Horner and Estrin form");
+
+  // Test 3: degree 12 with runtime coefficients; the automatic scheme is Estrin
+  const auto degree12 = [] {
+    return [&]<int... Ks>(std::integer_sequence<int, Ks...>) {
+      return (... + ((1.0 / (Ks + 1)) * (x ^ c<Ks>)));
+    }(std::make_integer_sequence<int, 13>{});
+  }();
+  const auto automatic = polynomial_form(degree12, x);
+  static_assert(std::is_same_v<expr_op_t<decltype(automatic)>,
+                               polynomial_evaluation<polynomial_scheme::estrin, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12>>);
+  for (double value : {-1.5, -0.25, 0.0, 0.5, 0.9})
+  {
+    const double expected = degree12(x = value);
+    if (!check_close(automatic(x = value), expected, 1e-12) || !check_close(horner(degree12, x)(x = value), expected, 1e-12))
+    {
+      std::println("FAIL: degree 12 at {}: estrin {}, horner {}, expected {}", value, automatic(x = value),
+                   horner(degree12, x)(x = value), expected);
+      return 1;
+    }
+  }
+  std::println("PASS: degree 12 polynomial");
+
+  // Test 4: multivariate. Coefficients in a and y, then rewritten in y
+  constexpr auto mixed = a * (x ^ c<2>) + b * y * x + (y ^ c<2>) * (x ^ c<2>) + (y ^ c<3>) + y + c<1>;
+  constexpr auto nested = horner(mixed, x, y);
+  static_assert(std::is_same_v<expr_op_t<decltype(nested)>, polynomial_evaluation<polynomial_scheme::horner, 0, 1, 2>>);
+  static_assert(std::is_same_v<expr_op_t<decltype(std::get<1>(nested.terms))>,
+                               polynomial_evaluation<polynomial_scheme::horner, 0, 1, 3>>, "constant term in y");
+  static_assert(nested(x = 2, y = 3, a = 5, b = 7) == mixed(x = 2, y = 3, a = 5, b = 7));
+  constexpr auto kept = nested(y = 3, a = 5, b = 7);
+  static_assert(std::is_same_v<expr_op_t<decltype(kept)>, polynomial_evaluation<polynomial_scheme::horner, 0, 1, 2>>,
+                "partial evaluation keeps the scheme");
+  static_assert(kept(x = 2) == mixed(x = 2, y = 3, a = 5, b = 7));
+  std::println("PASS: multivariate polynomial");
+
+  // Test 5: polynomials inside other expressions, partial evaluation and compile
+  constexpr auto quotient = (c<1> + x + (x ^ c<2>)) / (a + x);
+  constexpr auto rewritten = horner(quotient, x);
+  static_assert(is_div_expr_v<decltype(rewritten)>);
+  const auto partial = rewritten(x = 0.5);
+  static_assert(is_symbolic_v<std::remove_cvref_t<decltype(partial)>>);
+  const auto kernel = compile(rewritten, x, a);
+  if (!check_close(partial(a = 2.0), quotient(x = 0.5, a = 2.0)) || !check_close(kernel(0.5, 2.0), 0.7))
+  {
+    std::println("FAIL: rational function gave {} and {}", partial(a = 2.0), kernel(0.5, 2.0));
+    return 1;
+  }
+  std::println("PASS: polynomials inside expressions");
+
+  return 0;
+}
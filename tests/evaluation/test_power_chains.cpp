@@ -0,0 +1,89 @@
+/*
+ * test_power_chains.cpp
+ * part of test suite for lam.symbols
+ * Constant exponents: addition chains, reciprocals, sqrt/cbrt lowering and share_powers
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+
+constexpr symbol x;
+constexpr symbol y;
+
+// x^2 evaluated from a sequence covering x^3 and x^5 too
+template<typename Op>
+constexpr bool reads_powers_of_x = false;
+template<typename Sequence>
+constexpr bool reads_powers_of_x<shared_power<2, Sequence>> =
+  Sequence::chain.contains(2) && Sequence::chain.contains(3) && Sequence::chain.contains(5);
+
+int main()
+{
+  // Test 1: shortest chains, and addition sequences covering several exponents
+  static_assert(make_addition_chain(std::array<std::size_t, 1>{15}).size - 1 == 5, "x^15 in 5 multiplications");
+  static_assert(make_addition_chain(std::array<std::size_t, 1>{31}).size - 1 == 7, "x^31 in 7 multiplications");
+  static_assert(make_addition_chain(std::array<std::size_t, 3>{5, 3, 2}).size - 1 == 3, "x^2, x^3, x^5 share x^2");
+  static_assert(make_addition_chain(std::array<std::size_t, 1>{1000}).contains(1000), "binary method beyond the search");
+  static_assert(power_sequence<2, 3, 5>::power<5>(2) == 32);
+  std::println("PASS: addition chains");
+
+  // Test 2: integer exponents fold exactly and keep the result type of pow
+  constexpr auto cube = x * x * x;
+  static_assert(is_power_expr_v<decltype(cube)>);
+  static_assert(cube(x = 3.0) == 27.0);
+  static_assert(std::is_same_v<decltype(cube(x = 3)), double>, "integers promote to double, like std::pow");
+  static_assert((x ^ constant_symbol<-2>{})(x = 4.0) == 0.0625);
+  static_assert((x ^ constant_symbol<13>{})(x = 2.0) == 8192.0);
+  static_assert(std::is_same_v<decltype(cube(x = 2.0f)), float>);
+  std::println("PASS: integer exponents");
+
+  // Test 3: halves and exact thirds go through sqrt and cbrt, a floating third through pow
+  const double half = (x ^ constant_symbol<1.5>{})(x = 4.0);
+  const double third = (x ^ constant_symbol<rational{1, 3}>{})(x = -27.0);
+  const double negative_third = (x ^ constant_symbol<rational{-2, 3}>{})(x = 8.0);
+  const double floating_third = (x ^ constant_symbol<1.0 / 3.0>{})(x = -27.0);
+  const double other = (x ^ constant_symbol<0.7>{})(x = 2.0);
+  static_assert(!is_lowered_exponent_v<1.0 / 3.0, double>, "a floating third is left to pow");
+  if (!check_close(half, 8.0) || !check_close(third, -3.0) || !check_close(negative_third, 0.25) ||
+      floating_third == floating_third || !check_close(other, std::pow(2.0, 0.7)))
+  {
+    std::println("FAIL: x^1.5 = {}, x^(1/3) = {}, x^(-2/3) = {}, x^(1.0/3.0) = {}, x^0.7 = {}", half, third,
+                 negative_third, floating_third, other);
+    return 1;
+  }
+  std::println("PASS: sqrt and cbrt lowering");
+
+  // Test 4: partial evaluation keeps the exponent a constant_symbol
+  constexpr auto expr = (x + y) ^ constant_symbol<3>{};
+  constexpr auto partial = expr(y = constant_symbol<1>{});
+  static_assert(is_power_expr_v<decltype(partial)> && is_stateless_v<decltype(partial)>);
+  static_assert(partial(x = 1.0) == 8.0);
+  std::println("PASS: partial evaluation");
+
+  // Test 5: share_powers evaluates every power of x from one sequence
+  constexpr constant_symbol<2> two;
+  constexpr constant_symbol<3> three;
+  constexpr constant_symbol<5> five;
+  constexpr auto powers = (x ^ two) + (x ^ three) + y * (x ^ five) + (y ^ two);
+  constexpr auto shared = share_powers(powers);
+  // operands sit in canonical order, so find x^2 by the sequence it reads rather than its position
+  static_assert(std::apply([](const auto&... term) { return (reads_powers_of_x<expr_op_t<decltype(term)>> || ...); },
+                           shared.terms));
+  static_assert(is_stateless_v<decltype(shared)>);
+  static_assert(shared(x = 2.0, y = 3.0) == powers(x = 2.0, y = 3.0));
+  const auto kernel = compile(shared, x, y);
+  if (!check_close(kernel(1.5, -0.5), powers(x = 1.5, y = -0.5)))
+  {
+    std::println("FAIL: shared powers gave {}, expected {}", kernel(1.5, -0.5), powers(x = 1.5, y = -0.5));
+    return 1;
+  }
+  std::println("PASS: share_powers");
+
+  return 0;
+}
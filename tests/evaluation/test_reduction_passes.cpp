@@ -0,0 +1,94 @@
+/*
+ * test_reduction_passes.cpp
+ * part of test suite for lam.symbols
+ * balance() and compensate(): pairwise and Neumaier evaluation of N-ary sums and products
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+
+constexpr symbol a;
+constexpr symbol b;
+constexpr symbol c;
+constexpr symbol d;
+constexpr symbol e;
+
+int main()
+{
+  constexpr auto sum = a + b + c + d + e;
+  constexpr auto product = a * b * c * d;
+
+  // Test 1: structure. Long sums and products get the pairwise operator, binary nodes are kept
+  constexpr auto balanced = balance(sum + product);
+  using balanced_t = std::remove_cvref_t<decltype(balanced)>;
+  static_assert(std::is_same_v<expr_op_t<balanced_t>, pairwise<std::plus<void>>>);
+  static_assert(std::is_same_v<expr_op_t<std::tuple_element_t<5, decltype(balanced.terms)>>,
+                               pairwise<std::multiplies<void>>>, "nested product is balanced too");
+  static_assert(std::is_same_v<expr_op_t<decltype(balance(a + b))>, std::plus<void>>);
+  static_assert(std::is_same_v<expr_op_t<decltype(balance(product))>, pairwise<std::multiplies<void>>>);
+  static_assert(is_stateless_v<balanced_t>, "passes keep stateless expressions stateless");
+  static_assert(balance(sum)(a = 1, b = 2, c = 3, d = 4, e = 5) == 15);
+  static_assert(balance(product)(a = 1, b = 2, c = 3, d = 4) == 24);
+  std::println("PASS: balance rewrites N-ary nodes");
+
+  // Test 2: values agree with the left fold
+  const double expected = (sum + product)(a = 1.5, b = -2.25, c = 3.0, d = 0.125, e = 7.0);
+  const double got = balanced(a = 1.5, b = -2.25, c = 3.0, d = 0.125, e = 7.0);
+  if (!check_close(got, expected))
+  {
+    std::println("FAIL: balanced evaluation gave {}, expected {}", got, expected);
+    return 1;
+  }
+  std::println("PASS: balanced evaluation matches");
+
+  // Test 3: partial evaluation stays symbolic
+  const auto partial = balance(sum)(a = 1.0, b = 2.0);
+  static_assert(std::is_same_v<expr_op_t<std::remove_cvref_t<decltype(partial)>>, pairwise<std::plus<void>>>,
+                "partial evaluation keeps the pairwise tree");
+  if (!check_close(partial(c = 3.0, d = 4.0, e = 5.0), 15.0))
+  {
+    std::println("FAIL: partially evaluated balanced sum gave {}", partial(c = 3.0, d = 4.0, e = 5.0));
+    return 1;
+  }
+  std::println("PASS: partial evaluation of a balanced sum");
+
+  // Test 4: compensation recovers the 1 lost by the plain sums
+  constexpr auto cancelling = a + b + c;
+  const double plain = cancelling(a = 1e16, b = 1.0, c = -1e16);
+  const double tree = balance(cancelling)(a = 1e16, b = 1.0, c = -1e16);
+  const double compensated = compensate(cancelling)(a = 1e16, b = 1.0, c = -1e16);
+  if (plain != 0.0 || tree != 0.0 || compensated != 1.0)
+  {
+    std::println("FAIL: plain {}, balanced {}, compensated {} (expected 0, 0, 1)", plain, tree, compensated);
+    return 1;
+  }
+  const auto partially_compensated = compensate(cancelling)(a = 1e16, c = -1e16);
+  static_assert(std::is_same_v<expr_op_t<std::remove_cvref_t<decltype(partially_compensated)>>, compensated_plus>);
+  if (partially_compensated(b = 1.0) != 1.0)
+  {
+    std::println("FAIL: partially evaluated compensated sum gave {}", partially_compensated(b = 1.0));
+    return 1;
+  }
+  static_assert(std::is_same_v<expr_op_t<decltype(compensate(balance(sum)))>, compensated_plus>);
+  static_assert(compensate(sum)(a = 1, b = 2, c = 3, d = 4, e = 5) == 15, "integers fall back to pairwise sums");
+  std::println("PASS: compensated summation");
+
+  // Test 5: passes compose with compile and formula
+  constexpr auto kernel = compile(compensate(sum), a, b, c, d, e);
+  constexpr formula f = sum;
+  if (!check_close(kernel(1.0, 2.0, 3.0, 4.0, 5.0), 15.0) ||
+      !check_close(balance(f)(a = 1.0, b = 1.0, c = 1.0, d = 1.0, e = 1.0), 5.0))
+  {
+    std::println("FAIL: compiled or formula pass evaluation");
+    return 1;
+  }
+  std::println("PASS: passes compose with compile and formula");
+
+  return 0;
+}
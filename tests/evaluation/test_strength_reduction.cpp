@@ -0,0 +1,108 @@
+/*
+ * test_strength_reduction.cpp
+ * part of test suite for lam.symbols
+ * reduce_strength(): merged divisions, constant and shared reciprocals
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+using namespace lam::test::utils::constants;
+
+constexpr symbol x;
+constexpr symbol y;
+constexpr symbol z;
+constexpr symbol a;
+constexpr symbol b;
+constexpr symbol r;
+
+// Divisions left anywhere in a tree
+template<typename T>
+constexpr std::size_t divisions_in = 0;
+template<typename Op, typename... Terms>
+constexpr std::size_t divisions_in<symbolic_expression<Op, Terms...>> =
+  std::size_t{std::is_same_v<Op, std::divides<void>>} + (divisions_in<Terms> + ... + 0);
+template<typename T>
+constexpr std::size_t division_count = divisions_in<std::remove_cvref_t<T>>;
+
+int main()
+{
+  // Test 1: a / b / c is one division by a product
+  constexpr auto chained = x / a / b;
+  constexpr auto merged = reduce_strength(chained);
+  static_assert(division_count<decltype(chained)> == 2 && division_count<decltype(merged)> == 1);
+  static_assert(is_div_expr_v<decltype(merged)> && is_mul_expr_v<expr_rhs_t<decltype(merged)>>);
+  static_assert(merged(x = 12.0, a = 2.0, b = 3.0) == 2.0);
+  static_assert(division_count<decltype(reduce_strength(x / a / b / y))> == 1);
+  std::println("PASS: merged divisions");
+
+  // Test 2: division by a constant is multiplication by its reciprocal
+  constexpr auto scaled = reduce_strength(x / c<4>);
+  static_assert(division_count<decltype(scaled)> == 0);
+  static_assert(scaled(x = 3.0) == 0.75, "exact for powers of two");
+  static_assert(std::is_same_v<std::remove_cvref_t<decltype(reduce_strength(x / c<3>))>,
+                               std::remove_cvref_t<decltype(c<rational{1, 3}> * x)>>,
+                "the reciprocal of an integer stays exact");
+  static_assert(std::is_same_v<std::remove_cvref_t<decltype(reduce_strength(x / c<rational{2, 3}>))>,
+                               std::remove_cvref_t<decltype(c<rational{3, 2}> * x)>>);
+  const double third = reduce_strength((x + y) / c<3>)(x = 1.0, y = 2.0);
+  if (!check_close(third, 1.0, 1e-15))
+  {
+    std::println("FAIL: (x + y) / 3 gave {}", third);
+    return 1;
+  }
+  static_assert(division_count<decltype(reduce_strength(x / c<0>))> == 1, "division by zero is kept");
+  std::println("PASS: constant reciprocals");
+
+  // Test 3: a repeated denominator becomes one reciprocal, a single one stays a division
+  constexpr auto r3 = r ^ c<3>;
+  constexpr auto force = x / r3 + y / r3 + z / r3 + a / b;
+  constexpr auto reduced = reduce_strength(force);
+  static_assert(division_count<decltype(reduced)> == 1, "only a / b is left");
+  for (double value : {0.5, 1.0, 2.5})
+  {
+    const double expected = force(x = 1.0, y = -2.0, z = 3.0, a = 1.0, b = 4.0, r = value);
+    const double actual = reduced(x = 1.0, y = -2.0, z = 3.0, a = 1.0, b = 4.0, r = value);
+    if (!check_close(actual, expected, 1e-12))
+    {
+      std::println("FAIL: reduced force at r = {} gave {}, expected {}", value, actual, expected);
+      return 1;
+    }
+  }
+  std::println("PASS: shared reciprocals");
+
+  // Test 4: several outputs share one reciprocal, evaluated once by the bundle
+  constexpr auto gm = c<2>;
+  constexpr auto bundle = reduce_strength(gm * x / r3, gm * y / r3, gm * z / r3);
+  using bundle_t = std::remove_cvref_t<decltype(bundle)>;
+  static_assert(type_list_contains_v<symbolic_expression<reciprocal, std::remove_cvref_t<decltype(r3)>>,
+                                     typename bundle_t::shared_list>);
+  const auto [ax, ay, az] = bundle(x = 1.0, y = 2.0, z = -4.0, r = 2.0);
+  if (!check_close(ax, 0.25) || !check_close(ay, 0.5) || !check_close(az, -1.0))
+  {
+    std::println("FAIL: bundled force gave ({}, {}, {})", ax, ay, az);
+    return 1;
+  }
+  std::println("PASS: bundled reciprocals");
+
+  // Test 5: partial evaluation and compile of a reduced expression
+  const auto partial = reduced(r = 2.0, b = 4.0);
+  static_assert(is_symbolic_v<std::remove_cvref_t<decltype(partial)>>);
+  const auto kernel = compile(reduced, x, y, z, a, b, r);
+  const double expected = force(x = 1.0, y = 1.0, z = 1.0, a = 2.0, b = 4.0, r = 2.0);
+  if (!check_close(partial(x = 1.0, y = 1.0, z = 1.0, a = 2.0), expected) ||
+      !check_close(kernel(1.0, 1.0, 1.0, 2.0, 4.0, 2.0), expected))
+  {
+    std::println("FAIL: partial {} and compiled {}, expected {}", partial(x = 1.0, y = 1.0, z = 1.0, a = 2.0),
+                 kernel(1.0, 1.0, 1.0, 2.0, 4.0, 2.0), expected);
+    return 1;
+  }
+  std::println("PASS: partial evaluation and compile");
+
+  return 0;
+}
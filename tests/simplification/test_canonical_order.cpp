@@ -0,0 +1,62 @@
+/*
+ * test_canonical_order.cpp
+ * part of test suite for lam.symbols
+ * Canonical operand order: commuted sums and products of ordered symbols are one type, and cancel
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+using namespace lam::test::utils::constants;
+
+constexpr ordered_symbol<0> a;
+constexpr ordered_symbol<1> b;
+constexpr ordered_symbol<2> d;
+
+int main()
+{
+  // Test 1: commuted sums and products are one type
+  static_assert(same_v<decltype(a + b), decltype(b + a)>);
+  static_assert(same_v<decltype(a + b + d), decltype(d + a + b)>);
+  static_assert(same_v<decltype(a * b * d), decltype(d * b * a)>);
+  static_assert(same_v<decltype(c<3> * a + b), decltype(b + a * c<3>)>);
+  std::println("PASS: commuted operands");
+
+  // Test 2: constants lead, by value, and like terms sit side by side
+  using sum_of = std::plus<void>;
+  static_assert(canonical_before_v<sum_of, constant_symbol<1>, decltype(a)>);
+  static_assert(canonical_before_v<sum_of, constant_symbol<-2>, constant_symbol<5>>);
+  static_assert(canonical_before_v<sum_of, decltype(a), decltype(b)>);
+  static_assert(!canonical_before_v<sum_of, decltype(b), decltype(a)>);
+  static_assert(canonical_before_v<sum_of, decltype(a), decltype(a * b)>);
+  static_assert(same_v<decltype(c<2> * a + b + c<3> * a), decltype(c<5> * a + b)>);
+  static_assert(same_v<decltype(c<2> + a), decltype(a + c<2>)>);
+  std::println("PASS: order of kinds");
+
+  // Test 3: equal operands in another order now cancel
+  static_assert(same_v<decltype((a + b) - (b + a)), constant_symbol<0>>);
+  static_assert(same_v<decltype((a * b) / (b * a)), constant_symbol<1>>);
+  static_assert(same_v<decltype(a + b + d - (d + b + a)), constant_symbol<0>>);
+  std::println("PASS: cancellation");
+
+  // Test 4: reordering leaves the value alone
+  constexpr auto sum = d * c<2> + (b ^ c<2>) + a;
+  static_assert(sum(a = 1.0, b = 2.0, d = 3.0) == 1.0 + 4.0 + 6.0);
+  std::println("PASS: values");
+
+  // Test 5: plain symbols have no key, and keep the order they were combined in
+  constexpr symbol u;
+  constexpr symbol w;
+  static_assert(same_v<decltype(u + w), symbolic_expression<std::plus<void>, decltype(u), decltype(w)>>);
+  static_assert(!same_v<decltype(u + w), decltype(w + u)>);
+  static_assert(same_v<decltype(u * c<2>), decltype(c<2> * u)>, "constants still lead");
+  static_assert(same_v<decltype(u + a), symbolic_expression<std::plus<void>, decltype(u), decltype(a)>>);
+  std::println("PASS: plain symbols");
+
+  return 0;
+}
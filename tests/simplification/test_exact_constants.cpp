@@ -0,0 +1,63 @@
+/*
+ * test_exact_constants.cpp
+ * part of test suite for lam.symbols
+ * Exact rational and floating constant_symbols: folding, normalization and evaluation
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+using namespace lam::test::utils::constants;
+
+constexpr ordered_symbol<0> x;
+constexpr ordered_symbol<1> m;
+constexpr ordered_symbol<2> v;
+
+int main()
+{
+  // Test 1: quotients of integers fold to exact, reduced rationals
+  static_assert(same_v<decltype(c<1> / c<3>), constant_symbol<rational{1, 3}>>);
+  static_assert(same_v<decltype(c<2> / c<-6>), constant_symbol<rational{-1, 3}>>);
+  static_assert(same_v<decltype(c<6> / c<3>), constant_symbol<2>>);
+  static_assert(same_v<constant_symbol<rational{std::ratio<2, 6>{}}>, constant_symbol<rational{1, 3}>>);
+  std::println("PASS: exact quotients");
+
+  // Test 2: rational arithmetic stays exact, and an integer result is an int
+  static_assert(same_v<decltype(c<rational{1, 3}> + c<rational{2, 3}>), constant_symbol<1>>);
+  static_assert(same_v<decltype(c<rational{1, 2}> - c<1>), constant_symbol<rational{-1, 2}>>);
+  static_assert(same_v<decltype(c<rational{3, 4}> * c<rational{2, 3}>), constant_symbol<rational{1, 2}>>);
+  static_assert(same_v<decltype(c<rational{1, 2}> * c<0.5>), constant_symbol<0.25>>);
+  static_assert(same_v<decltype(c<0.5> * c<2>), constant_symbol<1>>);
+  std::println("PASS: exact arithmetic");
+
+  // Test 3: coefficient arithmetic folds away at compile time
+  constexpr auto kinetic = c<rational{1, 2}> * m * (v ^ c<2>);
+  static_assert(same_v<decltype(c<2> * kinetic), decltype(m * (v ^ c<2>))>);
+  static_assert(same_v<decltype(c<0.5> * x * c<2>), decltype(x)>);
+  static_assert(same_v<decltype(integrate(x ^ c<2>, x)), decltype(c<rational{1, 3}> * (x ^ c<3>))>);
+  std::println("PASS: folded coefficients");
+
+  // Test 4: a rational is converted to the type of the bound values when evaluated
+  static_assert(kinetic(m = 2.0, v = 3.0) == 9.0);
+  static_assert(same_v<decltype(kinetic(m = 2.0f, v = 3.0f)), float>);
+  static_assert((c<rational{1, 2}> * x)(x = 3) == 1.5);
+  static_assert(compile(kinetic, m, v)(4.0, 0.5) == 0.5);
+  std::println("PASS: evaluation");
+
+  // Test 5: rational exponents with denominator 2 or 3 lower to sqrt and cbrt
+  static_assert(is_lowered_exponent_v<rational{3, 2}, double> && is_lowered_exponent_v<rational{-2, 3}, double>);
+  if (!check_close((x ^ c<rational{3, 2}>)(x = 4.0), 8.0) || !check_close((x ^ c<rational{2, 3}>)(x = 8.0), 4.0))
+  {
+    std::println("FAIL: rational exponents gave {} and {}", (x ^ c<rational{3, 2}>)(x = 4.0),
+                 (x ^ c<rational{2, 3}>)(x = 8.0));
+    return 1;
+  }
+  std::println("PASS: rational exponents");
+
+  return 0;
+}
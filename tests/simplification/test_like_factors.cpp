@@ -0,0 +1,53 @@
+/*
+ * test_like_factors.cpp
+ * part of test suite for lam.symbols
+ * Like factors in flattened products: added exponents, one leading coefficient, reciprocals cancelled
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+using namespace lam::test::utils::constants;
+
+constexpr ordered_symbol<0> x;
+constexpr ordered_symbol<1> y;
+constexpr ordered_symbol<2> z;
+
+int main()
+{
+  // Test 1: powers of one base add their exponents, wherever they sit
+  static_assert(same_v<decltype(x * y * x), decltype((x ^ c<2>) * y)>);
+  static_assert(same_v<decltype((x * y) * (x ^ c<3>) * (y ^ c<2>)), decltype((x ^ c<4>) * (y ^ c<3>))>);
+  static_assert(same_v<decltype(x * y * z * x * y), decltype((x ^ c<2>) * (y ^ c<2>) * z)>);
+  std::println("PASS: like factors");
+
+  // Test 2: constant factors fold into one leading coefficient, and 1 leaves
+  static_assert(same_v<decltype((c<2> * x) * (c<3> * y)), decltype(c<6> * (x * y))>);
+  static_assert(same_v<decltype((c<2> * x) * y * c<3>), decltype(c<6> * (x * y))>);
+  static_assert(same_v<decltype((c<-1> * x) * (c<-1> * y)), decltype(x * y)>);
+  static_assert(same_v<decltype((c<2> * x) * y * c<0>), constant_symbol<0>>);
+  std::println("PASS: one coefficient");
+
+  // Test 3: a base cancels against its reciprocal
+  static_assert(same_v<decltype(x * y * (c<1> / x)), decltype(y)>);
+  static_assert(same_v<decltype((x ^ c<2>) * y * (x ^ c<-2>)), decltype(y)>);
+  static_assert(same_v<decltype(x * y * (c<1> / z) * (c<1> / z)), decltype(x * y * (z ^ c<-2>))>);
+  std::println("PASS: reciprocals");
+
+  // Test 4: the collected product has the value of the original
+  constexpr auto product = (c<2> * x) * y * (c<3> * x) * (c<1> / y) * z;
+  static_assert(same_v<decltype(product), decltype(c<6> * (x ^ c<2>) * z)>);
+  if (!check_close(product(x = 1.5, y = 7.0, z = -2.0), 6.0 * 1.5 * 1.5 * -2.0))
+  {
+    std::println("FAIL: collected product gave {}", product(x = 1.5, y = 7.0, z = -2.0));
+    return 1;
+  }
+  std::println("PASS: values");
+
+  return 0;
+}
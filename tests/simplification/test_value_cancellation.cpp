@@ -0,0 +1,55 @@
+/*
+ * test_value_cancellation.cpp
+ * part of test suite for lam.symbols
+ * Value-aware merging: like terms whose coefficients are runtime values still merge and cancel
+ * Extending Author: Colin Ford
+ * see github.com/colinrford/symbols for CC0-1.0 Universal License, and
+ *                                   for more info
+ */
+
+import std;
+import lam.symbols;
+import lam.test.utils;
+using namespace lam::symbols;
+using namespace lam::test::utils;
+using namespace lam::test::utils::constants;
+
+constexpr ordered_symbol<0> x;
+constexpr ordered_symbol<1> y;
+constexpr ordered_symbol<2> gm;
+constexpr ordered_symbol<3> m;
+
+int main()
+{
+  // Test 1: like terms with value coefficients add their coefficients
+  constexpr auto sum = 2.0 * x + 3.0 * x;
+  static_assert(same_v<decltype(sum), decltype(1.0 * x)> && std::get<0>(sum.terms) == 5.0);
+  static_assert(std::get<0>((x + 2.0 * x).terms) == 3.0);
+  constexpr auto product_sum = 2.0 * x * y + 3.0 * x * y;
+  static_assert(same_v<decltype(product_sum), decltype(1.0 * x * y)> && std::get<0>(product_sum.terms) == 5.0);
+  std::println("PASS: value coefficients");
+
+  // Test 2: values cancel, and the type does not depend on them
+  static_assert(same_v<decltype((x + 1.0) - (x + 2.0)), double> && (x + 1.0) - (x + 2.0) == -1.0);
+  static_assert(same_v<decltype(2.0 * x - 2.0 * x), decltype(1.0 * x)> && (2.0 * x - 2.0 * x)(x = 3.0) == 0.0);
+  static_assert((2.0 * x) / x == 2.0 && x / (4.0 * x) == 0.25 && (6.0 * x) / (3.0 * x) == 2.0);
+  std::println("PASS: value cancellation");
+
+  // Test 3: a partially substituted formula is as small as its stateless equivalent
+  constexpr auto merged = (x * gm + x * m)(gm = 1.5, m = 2.5);
+  static_assert(same_v<decltype(merged), decltype(1.0 * x)> && std::get<0>(merged.terms) == 4.0);
+  constexpr auto cancelled = (x * gm - x * m + y)(gm = 2.0, m = 2.0);
+  if (!check_close(cancelled(x = 5.0, y = -1.5), -1.5))
+  {
+    std::println("FAIL: cancelled partial gave {}", cancelled(x = 5.0, y = -1.5));
+    return 1;
+  }
+  std::println("PASS: partial substitution");
+
+  // Test 4: stateless operands keep the compile-time path
+  static_assert(!are_value_like_terms_v<decltype(c<2> * x), decltype(c<3> * x)>);
+  static_assert(same_v<decltype((x + y) - (x + y)), constant_symbol<0>>);
+  std::println("PASS: compile-time path");
+
+  return 0;
+}
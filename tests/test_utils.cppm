@@ -9,6 +9,7 @@
 export module lam.test.utils;
 
 import std;
+import lam.symbols;
 
 export namespace lam::test::utils
 {
@@ -29,4 +30,17 @@ constexpr bool check_close(const T& val, U expected, double tol = 1e-9)
   }
 }
 
+// Whether two expressions simplified to the same type
+template<typename T, typename U>
+constexpr bool same_v = std::is_same_v<std::remove_cvref_t<T>, std::remove_cvref_t<U>>;
+
 } // namespace lam::test::utils
+
+// c<3> for constant_symbol<3>{}; opt in with using namespace lam::test::utils::constants
+export namespace lam::test::utils::constants
+{
+
+template<auto V>
+constexpr lam::symbols::constant_symbol<V> c{};
+
+} // namespace lam::test::utils::constants